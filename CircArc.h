@@ -9,6 +9,7 @@
 #pragma once
 
 #include <cmath>
+#include <algorithm> // std::min, std::max
 #include <assert.h>
 
 #include "CircVal.h" // CircVal, CircValTypeDef
@@ -31,7 +32,7 @@ public:
     // ---------------------------------------------
     // construction based on a floating-point value
     // floating-point is truncated into the range [0, Type::R]
-    CircArcLen(double r) : l(__min(__max(0., r), Type::R))
+    CircArcLen(double r) : l(std::min(std::max(0., r), Type::R))
     {
     }
 
@@ -52,7 +53,7 @@ public:
     // floating-point is truncated into the range [0, Type::R]
     CircArcLen& operator= (double r)
     {
-        l = __min(__max(0., r), Type::R);
+        l = std::min(std::max(0., r), Type::R);
         return *this;
     }
 
@@ -4,6 +4,16 @@
 
 #pragma once
 
+#include <cmath>   // std::fma
+#include <new>     // std::align_val_t
+#include <bit>     // std::bit_cast
+#include <vector>
+#include <algorithm> // std::sort
+#include <numeric>   // std::iota
+#include <numbers>   // std::numbers::sqrt2, std::numbers::pi
+#include <cstdint>
+#include <functional> // std::equal_to
+
 // ==========================================================================
 // square (x*x)
 template <typename T>
@@ -12,6 +22,28 @@ T Sqr(const T& x)
     return x*x;
 }
 
+// ==========================================================================
+// 1 if the target has a hardware FMA instruction - where the compiler may contract x - y*z into a fused
+// multiply-subtract (gcc does so by default, also with -std=c++20)
+#if defined(__FP_FAST_FMA) || defined(__FMA__) || defined(__ARM_FEATURE_FMA)
+#define CIRCULAR_FMA 1
+#else
+#define CIRCULAR_FMA 0
+#endif
+
+// x - y*z, rounded the same way whether or not the compiler contracts floating-point expressions: fused (a single
+// rounding) where the target has a hardware FMA, a rounded product and difference otherwise (not contractible there).
+// used where the scalar and the SIMD paths (CircSimd.h: SimdMulSub) must agree bit for bit
+template <typename T>
+T MulSub(T x, T y, T z)
+{
+#if CIRCULAR_FMA
+    return std::fma(-y, z, x);
+#else
+    return x - y * z;
+#endif
+}
+
 // ==========================================================================
 // Floating-point modulo
 // The result (the remainder) has the same sign as the divisor.
@@ -24,7 +56,7 @@ T Mod(T x, T y)
     if (0. == y)
         return x;
 
-    double m = x - y * floor(x/y);
+    T m = MulSub(x, y, std::floor(x/y));
 
     // handle boundary cases resulting from floating-point limited accuracy:
 
@@ -57,3 +89,361 @@ T Mod(T x, T y)
 
     return m;
 }
+
+// ==========================================================================
+// Floating-point modulo for a positive divisor y, with a precomputed yInv= 1/y (no division)
+// identical to Mod(x,y) when y is a power of two (x*(1/y) == x/y). otherwise floor(x*yInv) may be off by one
+// near multiples of y, which the boundary cases handle the same way as Mod
+template<typename T>
+T ModInv(T x, T y, T yInv)
+{
+    static_assert(!std::numeric_limits<T>::is_exact , "ModInv: floating-point type expected");
+
+    T m = MulSub(x, y, std::floor(x * yInv));
+
+    if (m >= y)               // modulo range: [0..y)
+        return 0;
+
+    if (m < 0 )
+        return y + m == y ? 0 : y + m;
+
+    return m;
+}
+
+// ==========================================================================
+// round to the nearest integer, ties to even (as nearbyint in the default rounding mode), |x| < 2^51.
+// larger values are returned as is. unlike nearbyint, inlined without SSE4.1 (adding 1.5*2^52 drops the fraction)
+inline double RoundNearest(double x)
+{
+    constexpr double Magic = 0x1.8p52;
+    const     double q     = (x + Magic) - Magic;
+    return std::abs(x) < 0x1p51 ? q : x;
+}
+
+// single-precision: |x| < 2^22
+inline float RoundNearest(float x)
+{
+    constexpr float Magic = 0x1.8p23f;
+    const     float q     = (x + Magic) - Magic;
+    return std::abs(x) < 0x1p22f ? q : x;
+}
+
+// ==========================================================================
+// true if x is an integral power of two (2^k, k may be negative)
+constexpr bool IsPow2(double x)
+{
+    if (!(x > 0.))
+        return false;
+
+    while (x >= 2.) x /= 2.;
+    while (x <  1.) x *= 2.;
+    return std::equal_to<double>{}(x, 1.);
+}
+
+// ==========================================================================
+// sine and cosine of x, |x| <= pi/4 (Cephes polynomials; max error ~1 ULP)
+// branch-free, so loops over arrays can be vectorized
+inline void SinCosPi4(double x, double& s, double& c)
+{
+    const double z = x * x;
+
+    s = x + x * z * (((((( 1.58962301576546568060E-10  * z
+                          - 2.50507477628578072866E-8 ) * z
+                          + 2.75573136213857245213E-6 ) * z
+                          - 1.98412698295895385996E-4 ) * z
+                          + 8.33333333332211858878E-3 ) * z
+                          - 1.66666666666666307295E-1 ));
+
+    c = 1. - 0.5 * z + z * z * (((((( -1.13585365213876817300E-11  * z
+                                     + 2.08757008419747316778E-9 ) * z
+                                     - 2.75573141792967388112E-7 ) * z
+                                     + 2.48015872888517045348E-5 ) * z
+                                     - 1.38888888888730564116E-3 ) * z
+                                     + 4.16666666666665929218E-2 ));
+}
+
+// ==========================================================================
+// sine and cosine of the angle v*Scale radians, with quadrant-based argument reduction: v= q*Q + r, where Q= Q1+Q2+Q3
+// is a quarter turn in the unit of v, InvQ= 1/Q, Scale= (pi/2)/Q, and q is the nearest integer to v/Q (|v/Q| < 2^51).
+// Q1 (and Q2) have trailing zero bits, so q*Q1 (q*Q2) are exact for small q (Cody-Waite reduction). when Q is Q1 alone
+// (e.g. 90 degrees), r is exact - so at multiples of Q, the results are exactly 0 and +-1.
+// SinCosPi4(r*Scale) is rotated by q quarter turns: a swap and sign flips, selected by the low bits of q.
+// branch-free, so loops over arrays can be vectorized (SimdSinCos in CircSimd.h is lane-wise identical)
+inline void SinCosQuadrant(double v, double InvQ, double Q1, double Q2, double Q3, double Scale, double& s, double& c)
+{
+    constexpr double Magic = 0x1.8p52;
+    const     double k     = v * InvQ + Magic; // q in the low bits of the mantissa
+    const     double q     = k - Magic;
+    const     double r     = ((v - q * Q1) - q * Q2) - q * Q3;
+
+    double s0, c0;
+    SinCosPi4(r * Scale, s0, c0);
+
+    const uint64_t n     = std::bit_cast<uint64_t>(k);
+    const bool     bSwap = (n & 1) != 0;                                                    // odd quadrant: sin <-> cos
+    s = std::bit_cast<double>(std::bit_cast<uint64_t>(bSwap ? c0 : s0) ^ ((n       & 2) << 62)); // quadrants 2,3: -sin
+    c = std::bit_cast<double>(std::bit_cast<uint64_t>(bSwap ? s0 : c0) ^ (((n + 1) & 2) << 62)); // quadrants 1,2: -cos
+}
+
+// ==========================================================================
+// inverse of the standard normal CDF (Phi^-1), 0 < p < 1
+// P. J. Acklam's rational approximations (relative error < 1.15e-9), refined by one step of Halley's method on
+// Phi(x) - p, with Phi calculated by erfc: relative error ~1e-15 for 1e-300 <= p <= 0.5 (p is clamped at 1e-300).
+// above that, the accuracy is limited by the resolution of p near 1 - so upper-tail quantiles are better computed as -Phi^-1(1-p)
+// branch-free: both the central and the tail approximations are evaluated, and the result is selected, so the cost is constant
+inline double NormalQuantile(double p)
+{
+    const double t  = std::max(std::min(p, 1. - p), 1e-300);   // tail probability
+    const double q  = p - 0.5;
+    const double r  = q * q;
+    const double s  = std::sqrt(-2. * std::log(t));
+
+    const double xc = (((((( -3.969683028665376e+01  * r
+                            + 2.209460984245205e+02) * r
+                            - 2.759285104469687e+02) * r
+                            + 1.383577518672690e+02) * r
+                            - 3.066479806614716e+01) * r
+                            + 2.506628277459239e+00) * q) /
+                      ((((( -5.447609879822406e+01  * r
+                           + 1.615858368580409e+02) * r
+                           - 1.556989798598866e+02) * r
+                           + 6.680131188771972e+01) * r
+                           - 1.328068155288572e+01) * r + 1.);
+
+    const double xt = ((((( -7.784894002430293e-03  * s
+                           - 3.223964580411365e-01) * s
+                           - 2.400758277161838e+00) * s
+                           - 2.549732539343734e+00) * s
+                           + 4.374664141464968e+00) * s
+                           + 2.938163982698783e+00) /
+                      (((( 7.784695709041462e-03  * s
+                          + 3.224671290700398e-01) * s
+                          + 2.445134137142996e+00) * s
+                          + 3.754408661907416e+00) * s + 1.);  // lower tail (negative)
+
+    const double x  = t < 0.02425 ? (q < 0 ? xt : -xt) : xc;
+
+    // Halley step: e = Phi(x) - p, u = e/phi(x)
+    const double e  = std::erfc(-x / std::numbers::sqrt2) / 2. - p;
+    const double u  = e * std::sqrt(2. * std::numbers::pi) * std::exp(x * x / 2.);
+    return x - u / (1. + x * u / 2.);
+}
+
+// ==========================================================================
+// error-free product: a*b = p+e exactly (unless underflow)
+inline void TwoProd(double a, double b, double& p, double& e)
+{
+    p = a * b;
+    e = std::fma(a, b, -p);
+}
+
+// ==========================================================================
+// Neumaier (improved Kahan-Babuska) compensated summation. the sum is hi+lo, where lo accumulates the rounding errors of hi
+// AddProduct also accumulates the rounding errors of the products (Ogita-Rump-Oishi Dot2),
+// so sums of products are as accurate as if calculated in twice the working precision
+struct CompensatedSum
+{
+    double hi = 0.;
+    double lo = 0.;
+
+    void Add(double x)
+    {
+        const double t = hi + x;
+        lo += std::abs(hi) >= std::abs(x) ? (hi - t) + x : (x - t) + hi;
+        hi  = t;
+    }
+
+    void Add(const CompensatedSum& s)
+    {
+        Add(s.hi);
+        lo += s.lo;
+    }
+
+    // add a*b
+    void AddProduct(double a, double b)
+    {
+        double p, e;
+        TwoProd(a, b, p, e);
+        Add(p);
+        lo += e;
+    }
+
+    // add a*b*c
+    void AddProduct(double a, double b, double c)
+    {
+        double p, e;
+        TwoProd(a, b, p, e);
+        AddProduct(p, c);
+        lo += e * c;
+    }
+
+    operator double() const { return hi + lo; }
+};
+
+// ==========================================================================
+// allocator of aligned memory blocks (e.g. for SIMD loads/stores of contiguous arrays)
+template <typename T, size_t Align = 64>
+struct AlignedAllocator
+{
+    static_assert(Align >= alignof(T) && (Align & (Align - 1)) == 0, "AlignedAllocator: invalid alignment");
+
+    typedef T value_type;
+
+    template <typename U> struct rebind { typedef AlignedAllocator<U, Align> other; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+
+    void deallocate(T* p, size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    template <typename U> bool operator==(const AlignedAllocator<U, Align>&) const noexcept { return true ; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Align>&) const noexcept { return false; }
+};
+
+// ==========================================================================
+// monotonic mapping of double to uint64 - the radix-sort key
+inline uint64_t RadixSortKey(double x)
+{
+    constexpr uint64_t SignBit = uint64_t(1) << 63;
+
+    const uint64_t u = std::bit_cast<uint64_t>(x);
+    return (u & SignBit) ? ~u : (u | SignBit);
+}
+
+// LSD radix sort of floating-point values (ascending; -0 is sorted before +0)
+// O(n): 6 passes of 11 bits; passes in which all values share the same digit are skipped
+// small arrays (where the histograms' overhead dominates) are sorted by std::sort
+// tmp, Hist are scratch buffers (no allocation if their capacities suffice). on return, v holds the sorted values
+inline void RadixSort(std::vector<double>& v, std::vector<double>& tmp, std::vector<size_t>& Hist)
+{
+    constexpr unsigned nBits    = 11                          ;
+    constexpr unsigned nPasses  = (64 + nBits - 1) / nBits    ;
+    constexpr size_t   nBuckets = size_t(1) << nBits          ;
+    constexpr auto     Key      = RadixSortKey                ;
+
+    const size_t n = v.size();
+    if (n < 4096)
+    {
+        std::sort(v.begin(), v.end());
+        return;
+    }
+
+    tmp.resize(n);
+
+    Hist.assign(nPasses * nBuckets, 0);
+    for (const double x : v)
+    {
+        const uint64_t k = Key(x);
+        for (unsigned p = 0; p < nPasses; ++p)
+            ++Hist[p*nBuckets + ((k >> (p*nBits)) & (nBuckets-1))];
+    }
+
+    const uint64_t k0 = Key(v[0]);
+    for (unsigned p = 0; p < nPasses; ++p)
+    {
+        size_t* h = &Hist[p*nBuckets];
+        if (h[(k0 >> (p*nBits)) & (nBuckets-1)] == n) // all values share the same digit
+            continue;
+
+        // bucket start positions
+        size_t nPos = 0;
+        for (size_t b = 0; b < nBuckets; ++b)
+        {
+            const size_t c = h[b];
+            h[b]  = nPos;
+            nPos += c;
+        }
+
+        for (const double x : v)
+            tmp[h[(Key(x) >> (p*nBits)) & (nBuckets-1)]++] = x;
+
+        v.swap(tmp);
+    }
+}
+
+inline void RadixSort(std::vector<double>& v, std::vector<double>& tmp)
+{
+    std::vector<size_t> Hist;
+    RadixSort(v, tmp, Hist);
+}
+
+// LSD radix sort of floating-point keys (ascending), permuting the values along - as RadixSort, but stable: values
+// of equal keys keep their order. the keys and values are kept in separate arrays (no <key,value> pairs)
+// small arrays are sorted by std::sort of an index permutation (held in Hist); there, -0 and +0 are equal keys
+// KeysTmp, ValsTmp, Hist are scratch buffers (no allocation if their capacities suffice). on return, Keys holds the
+// sorted keys and Vals the permuted values
+inline void RadixSort(std::vector<double>& Keys, std::vector<double>& Vals,
+                      std::vector<double>& KeysTmp, std::vector<double>& ValsTmp, std::vector<size_t>& Hist)
+{
+    constexpr unsigned nBits    = 11                          ;
+    constexpr unsigned nPasses  = (64 + nBits - 1) / nBits    ;
+    constexpr size_t   nBuckets = size_t(1) << nBits          ;
+    constexpr auto     Key      = RadixSortKey                ;
+
+    const size_t n = Keys.size();
+    KeysTmp.resize(n);
+    ValsTmp.resize(n);
+
+    if (n < 512) // the index sort compares indirectly - so the radix sort pays off earlier than in RadixSort(v, ...)
+    {
+        Hist.resize(n);
+        std::iota(Hist.begin(), Hist.end(), size_t(0));
+        std::sort(Hist.begin(), Hist.end(), [&](size_t i, size_t j)
+        {
+            return Keys[i] < Keys[j] || (Keys[i] == Keys[j] && i < j);
+        });
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            KeysTmp[i] = Keys[Hist[i]];
+            ValsTmp[i] = Vals[Hist[i]];
+        }
+
+        Keys.swap(KeysTmp);
+        Vals.swap(ValsTmp);
+        return;
+    }
+
+    Hist.assign(nPasses * nBuckets, 0);
+    for (const double x : Keys)
+    {
+        const uint64_t k = Key(x);
+        for (unsigned p = 0; p < nPasses; ++p)
+            ++Hist[p*nBuckets + ((k >> (p*nBits)) & (nBuckets-1))];
+    }
+
+    const uint64_t k0 = Key(Keys[0]);
+    for (unsigned p = 0; p < nPasses; ++p)
+    {
+        size_t* h = &Hist[p*nBuckets];
+        if (h[(k0 >> (p*nBits)) & (nBuckets-1)] == n) // all keys share the same digit
+            continue;
+
+        // bucket start positions
+        size_t nPos = 0;
+        for (size_t b = 0; b < nBuckets; ++b)
+        {
+            const size_t c = h[b];
+            h[b]  = nPos;
+            nPos += c;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const size_t j = h[(Key(Keys[i]) >> (p*nBits)) & (nBuckets-1)]++;
+            KeysTmp[j] = Keys[i];
+            ValsTmp[j] = Vals[i];
+        }
+
+        Keys.swap(KeysTmp);
+        Vals.swap(ValsTmp);
+    }
+}
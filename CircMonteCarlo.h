@@ -0,0 +1,325 @@
+// ==========================================================================
+// Copyright (C) 2026 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+// classes defined here:
+// CircMonteCarlo       - parallel Monte Carlo harness for comparing estimators of circular values
+// CircMonteCarloTester - tester for CircMonteCarlo class
+// ==========================================================================
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <ostream>
+#include <sstream>
+#include <limits>
+#include <chrono>
+#include <random>          // std::uniform_real_distribution
+#include <algorithm>       // std::max, std::sort
+#include <assert.h>
+
+#include "CircVal.h"       // CircVal
+#include "CircHelper.h"    // CompensatedSum
+#include "CircParallel.h"  // ThreadCount, WorkStealingRun
+#include "PhiloxEngine.h"  // PhiloxEngine
+
+// ==========================================================================
+// Monte Carlo harness: for each value of a parameter grid, runs nTrials trials. each trial draws nSamples samples
+// from the distribution (which also returns the true value), and applies all the estimators to the samples.
+// the result of each (parameter value, estimator) is the RMS, mean (bias) and maximum of the estimation error.
+//
+// the trials are split into tasks of nTrialsPerTask trials, which run on a work-stealing thread pool.
+// each task draws its samples from its own stream of a counter-based engine: PhiloxEngine(nSeed, task),
+// so the samples do not depend on the number of threads or on the scheduling, and a run is reproducible from nSeed.
+// the errors are accumulated in per-worker accumulators (compensated sums), which are merged at the end
+// Type should be defined using the CircValType template
+template <typename Type>
+class CircMonteCarlo
+{
+public:
+    typedef std::vector<CircVal<Type>> Samples;
+
+    // fill S (S.size() samples) for parameter value fParam, and return the true value
+    typedef std::function<CircVal<Type>(double fParam, PhiloxEngine& Engine, Samples& S)> Distribution;
+
+    // estimate the true value from the samples
+    typedef std::function<CircVal<Type>(const Samples& S)> Estimator;
+
+    struct Result
+    {
+        double      fParam    ;
+        std::string sEstimator;
+        size_t      nTrials   ;
+        double      fRMS      ; // root mean square error: sqrt(sum(err^2) / (nTrials-1))
+        double      fBias     ; // mean error (signed distance from the true value)
+        double      fMaxErr   ; // maximum absolute error
+        double      fTime     ; // total run time of the estimator, for the parameter value (excluding the sampling) [s]
+    };
+
+    struct TimeStats // [s]
+    {
+        double fMin    = 0.;
+        double fMedian = 0.;
+        double fMean   = 0.;
+        double fMax    = 0.;
+    };
+
+private:
+    struct Accumulator
+    {
+        CompensatedSum Sum          ;
+        CompensatedSum SumSqr       ;
+        double         fMaxErr  = 0.;
+        size_t         nTrials  = 0 ;
+        double         fTime    = 0.; // [s]
+
+        void Add(const Accumulator& a)
+        {
+            Sum   .Add(a.Sum   );
+            SumSqr.Add(a.SumSqr);
+            fMaxErr  = std::max(fMaxErr, a.fMaxErr);
+            nTrials += a.nTrials;
+            fTime   += a.fTime;
+        }
+    };
+
+    std::string                                    m_sDistribution;
+    Distribution                                   m_Distribution ;
+    std::string                                    m_sParam       ;
+    std::vector<double>                            m_Grid         ; // sorted
+    std::vector<std::pair<std::string, Estimator>> m_Estimators   ;
+
+    std::vector<Result> m_Results         ; // sorted by parameter value, then by estimator (in order of addition)
+    double              m_fWallTime   = 0.; // [s]
+    TimeStats           m_TaskTime        ;
+    unsigned            m_nThreads    = 0 ;
+    size_t              m_nTasks      = 0 ;
+    size_t              m_nTrials     = 0 ; // total number of trials (all parameter values)
+    uint64_t            m_nSeed       = 0 ;
+
+    static std::string JsonString(const std::string& s)
+    {
+        std::string r = "\"";
+        for (const char c : s)
+        {
+            if (c == '"' || c == '\\')
+                r += '\\';
+            r += c;
+        }
+        return r + "\"";
+    }
+
+public:
+    // ---------------------------------------------
+    CircMonteCarlo(std::string sDistribution, Distribution Dist, std::string sParam, std::vector<double> Grid)
+        : m_sDistribution(std::move(sDistribution)), m_Distribution(std::move(Dist)), m_sParam(std::move(sParam)), m_Grid(std::move(Grid))
+    {
+        std::sort(m_Grid.begin(), m_Grid.end());
+    }
+
+    void AddEstimator(std::string sName, Estimator Est)
+    {
+        m_Estimators.emplace_back(std::move(sName), std::move(Est));
+    }
+
+    // ---------------------------------------------
+    // nThreads = 0: use all hardware threads
+    void Run(size_t nTrials, size_t nSamples, uint64_t nSeed, unsigned nThreads = 0, size_t nTrialsPerTask = 1000)
+    {
+        const size_t nPoints = m_Grid.size();
+        const size_t nEst    = m_Estimators.size();
+        const size_t nChunks = (nTrials + nTrialsPerTask - 1) / nTrialsPerTask; // tasks per parameter value
+
+        m_nThreads = ThreadCount(nThreads);
+        m_nTasks   = nPoints * nChunks;
+        m_nTrials  = nPoints * nTrials;
+        m_nSeed    = nSeed;
+
+        // per-worker accumulators [point * nEst + estimator], and task times
+        std::vector<std::vector<Accumulator>> Acc       (m_nThreads, std::vector<Accumulator>(nPoints * nEst));
+        std::vector<double>                   TaskTime  (m_nTasks);
+
+        const auto Time0 = std::chrono::steady_clock::now();
+
+        WorkStealingRun(m_nTasks, m_nThreads, [&](size_t t, unsigned w)
+        {
+            const auto   TaskTime0   = std::chrono::steady_clock::now();
+            const size_t p           = t / nChunks;                            // parameter value
+            const size_t c           = t % nChunks;                            // chunk
+            const size_t nTaskTrials = std::min(nTrialsPerTask, nTrials - c * nTrialsPerTask);
+
+            PhiloxEngine Engine(nSeed, t);
+            Samples      S(nSamples);
+            Accumulator* A = Acc[w].data() + p * nEst;
+
+            for (size_t i = 0; i < nTaskTrials; ++i)
+            {
+                const CircVal<Type> True = m_Distribution(m_Grid[p], Engine, S);
+                for (size_t e = 0; e < nEst; ++e)
+                {
+                    const auto          EstTime0 = std::chrono::steady_clock::now();
+                    const CircVal<Type> Est      = m_Estimators[e].second(S);
+                    A[e].fTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - EstTime0).count();
+
+                    const double fErr = CircVal<Type>::Sdist(True, Est);
+                    A[e].Sum   .Add(fErr);
+                    A[e].SumSqr.AddProduct(fErr, fErr);
+                    A[e].fMaxErr = std::max(A[e].fMaxErr, std::abs(fErr));
+                    ++A[e].nTrials;
+                }
+            }
+
+            TaskTime[t] = std::chrono::duration<double>(std::chrono::steady_clock::now() - TaskTime0).count();
+        });
+
+        m_fWallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Time0).count();
+
+        // merge
+        m_Results.clear();
+        for (size_t p = 0; p < nPoints; ++p)
+            for (size_t e = 0; e < nEst; ++e)
+            {
+                Accumulator a;
+                for (unsigned w = 0; w < m_nThreads; ++w)
+                    a.Add(Acc[w][p * nEst + e]);
+
+                const double fRMS  = a.nTrials > 1 ? std::sqrt(std::max(0., (double)a.SumSqr) / (a.nTrials - 1)) : 0.;
+                const double fBias = a.nTrials > 0 ? (double)a.Sum / a.nTrials                                   : 0.;
+                m_Results.push_back({ m_Grid[p], m_Estimators[e].first, a.nTrials, fRMS, fBias, a.fMaxErr, a.fTime });
+            }
+
+        m_TaskTime = TimeStats();
+        if (!TaskTime.empty())
+        {
+            std::sort(TaskTime.begin(), TaskTime.end());
+            double fSum = 0.;
+            for (const double f : TaskTime)
+                fSum += f;
+
+            m_TaskTime.fMin    = TaskTime.front();
+            m_TaskTime.fMedian = TaskTime[TaskTime.size() / 2];
+            m_TaskTime.fMean   = fSum / TaskTime.size();
+            m_TaskTime.fMax    = TaskTime.back();
+        }
+    }
+
+    // ---------------------------------------------
+    const std::vector<Result>& Results () const { return m_Results  ; }
+    double                     WallTime() const { return m_fWallTime; } // [s]
+    const TimeStats&           TaskTime() const { return m_TaskTime ; } // [s]
+
+    size_t                     TotalTrials() const { return m_nTrials; }
+
+    double Throughput() const // trials per second
+    {
+        return m_fWallTime > 0. ? m_nTrials / m_fWallTime : 0.;
+    }
+
+    // ---------------------------------------------
+    // one line per (parameter value, estimator), sorted. time_s and trials_per_s are of the estimator alone (excluding the sampling)
+    void WriteCSV(std::ostream& os) const
+    {
+        std::ostringstream ss;
+        ss.precision(std::numeric_limits<double>::max_digits10);
+        ss << "distribution," << m_sParam << ",estimator,trials,rms,bias,max_abs_err,time_s,trials_per_s\n";
+        for (const Result& r : m_Results)
+            ss << m_sDistribution << "," << r.fParam << "," << r.sEstimator << "," << r.nTrials << "," << r.fRMS << "," << r.fBias << ","
+               << r.fMaxErr << "," << r.fTime << "," << (r.fTime > 0. ? r.nTrials / r.fTime : 0.) << "\n";
+
+        os << ss.str();
+    }
+
+    // run summary (threads, wall time, throughput, task time statistics) and the results
+    void WriteJSON(std::ostream& os) const
+    {
+        std::ostringstream ss;
+        ss.precision(std::numeric_limits<double>::max_digits10);
+        ss << "{\n"
+           << "  \"distribution\": " << JsonString(m_sDistribution) << ",\n"
+           << "  \"param\": "        << JsonString(m_sParam       ) << ",\n"
+           << "  \"seed\": "         << m_nSeed                     << ",\n"
+           << "  \"threads\": "      << m_nThreads                  << ",\n"
+           << "  \"tasks\": "        << m_nTasks                    << ",\n"
+           << "  \"trials\": "       << TotalTrials()               << ",\n"
+           << "  \"wall_time_s\": "  << m_fWallTime                 << ",\n"
+           << "  \"trials_per_s\": " << Throughput()                << ",\n"
+           << "  \"task_time_s\": { \"min\": " << m_TaskTime.fMin << ", \"median\": " << m_TaskTime.fMedian
+           << ", \"mean\": " << m_TaskTime.fMean << ", \"max\": " << m_TaskTime.fMax << " },\n"
+           << "  \"results\": [";
+
+        for (size_t i = 0; i < m_Results.size(); ++i)
+        {
+            const Result& r = m_Results[i];
+            ss << (i ? "," : "") << "\n    { " << JsonString(m_sParam) << ": " << r.fParam << ", \"estimator\": " << JsonString(r.sEstimator)
+               << ", \"trials\": " << r.nTrials << ", \"rms\": " << r.fRMS << ", \"bias\": " << r.fBias << ", \"max_abs_err\": " << r.fMaxErr
+               << ", \"time_s\": " << r.fTime << " }";
+        }
+
+        ss << "\n  ]\n}\n";
+        os << ss.str();
+    }
+};
+
+// ==========================================================================
+// tester for CircMonteCarlo class
+template <typename Type>
+class CircMonteCarloTester
+{
+public:
+    CircMonteCarloTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        // uniform noise of width fParam around a random true value
+        auto Dist = [](double fParam, PhiloxEngine& Engine, std::vector<CircVal<Type>>& S)
+        {
+            std::uniform_real_distribution<double> ud(Type::L, Type::H), nd(-fParam / 2., fParam / 2.);
+            const CircVal<Type> True = ud(Engine);
+            for (auto& s : S)
+                s = (double)True + nd(Engine);
+            return True;
+        };
+
+        CircMonteCarlo<Type> MC("uniform", Dist, "width", { Type::R / 8., 0., Type::R / 4. });
+        MC.AddEstimator("first", [](const std::vector<CircVal<Type>>& S) { return S.front(); });
+        MC.AddEstimator("zero" , [](const std::vector<CircVal<Type>>&  ) { return CircVal<Type>(Type::Z); });
+
+        MC.Run(2500, 10, 1234, 3, 1000); // a partial task per parameter value
+        const auto R = MC.Results();
+        assert(R.size() == 6 && MC.TotalTrials() == 7500);
+
+        // sorted by parameter value, then by estimator
+        assert(R[0].fParam == 0. && R[2].fParam == Type::R / 8. && R[4].fParam == Type::R / 4.);
+        assert(R[0].sEstimator == "first" && R[1].sEstimator == "zero");
+
+        // width 0: no error. otherwise: uniform error in [-w/2,w/2]: rms w/sqrt(12)
+        assert(R[0].fRMS == 0. && R[0].fMaxErr == 0.);
+        for (size_t i : { 2, 4 })
+        {
+            assert(R[i].nTrials == 2500);
+            assert(std::abs(R[i].fRMS / (R[i].fParam / std::sqrt(12.)) - 1.) < 0.05);
+            assert(R[i].fMaxErr <= R[i].fParam / 2.);
+        }
+
+        // uniform error in [-R/2,R/2) for the constant estimator: rms R/sqrt(12)
+        assert(std::abs(R[1].fRMS / (Type::R / std::sqrt(12.)) - 1.) < 0.05);
+
+        // the results do not depend on the number of threads (up to the rounding of the merge)
+        MC.Run(2500, 10, 1234, 1, 1000);
+        const auto R1 = MC.Results();
+        for (size_t i = 0; i < R.size(); ++i)
+            assert(std::abs(R1[i].fRMS - R[i].fRMS) <= 1e-12 * R[i].fRMS && R1[i].fMaxErr == R[i].fMaxErr);
+
+        // machine-readable output: header + 6 lines
+        std::ostringstream csv, json;
+        MC.WriteCSV (csv );
+        MC.WriteJSON(json);
+        const std::string sCSV = csv.str(), sJSON = json.str();
+        assert(std::count(sCSV.begin(), sCSV.end(), '\n') == 7);
+        assert(sJSON.find("\"trials_per_s\"") != std::string::npos);
+    }
+};
@@ -0,0 +1,150 @@
+// ==========================================================================
+// Copyright (C) 2026 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+// functions defined here:
+// ThreadCount     - number of threads to use (0: the number of hardware threads)
+// ParallelRun     - run tasks concurrently, each on its own thread
+// WorkStealingRun - run tasks on a fixed number of worker threads, with work stealing
+// ParallelSort    - parallel sort of floating-point values
+//
+// users of these functions link with the platform's thread library (CMake: Threads::Threads)
+// ==========================================================================
+
+#pragma once
+
+#include <cstddef>         // size_t
+#include <vector>
+#include <algorithm>       // std::sort, std::merge, std::min, std::max
+#include <thread>
+#include <mutex>
+#include <deque>
+
+// ==========================================================================
+// number of threads to use: nThreads, or the number of hardware threads if nThreads is 0
+inline unsigned ThreadCount(unsigned nThreads)
+{
+    return nThreads ? nThreads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+// run f(t) for t in [0,nTasks) concurrently - each on its own thread (f(0) on the calling thread)
+template <typename F>
+void ParallelRun(size_t nTasks, F f)
+{
+    std::vector<std::thread> Threads;
+    Threads.reserve(nTasks);
+    for (size_t t = 1; t < nTasks; ++t)
+        Threads.emplace_back(f, t);
+
+    if (nTasks)
+        f(size_t(0));
+
+    for (auto& th : Threads)
+        th.join();
+}
+
+// run f(t, w) for t in [0,nTasks) on nWorkers threads (w in [0,nWorkers) is the worker running the task), with work stealing:
+// the tasks are dealt round-robin to per-worker deques; each worker takes tasks from the front of its own deque,
+// and when it is empty - steals from the back of the other workers' deques. suits tasks of uneven cost
+template <typename F>
+void WorkStealingRun(size_t nTasks, unsigned nWorkers, F f)
+{
+    struct alignas(64) TaskDeque // own cache line
+    {
+        std::mutex         Mutex;
+        std::deque<size_t> Tasks;
+    };
+
+    nWorkers = std::max(1u, nWorkers);
+    std::vector<TaskDeque> Deques(nWorkers);
+    for (size_t t = 0; t < nTasks; ++t)
+        Deques[t % nWorkers].Tasks.push_back(t);
+
+    ParallelRun(nWorkers, [&](size_t w)
+    {
+        for (;;)
+        {
+            size_t t     = 0;
+            bool   bTask = false;
+
+            for (unsigned k = 0; k < nWorkers && !bTask; ++k)
+            {
+                TaskDeque&                  D = Deques[(w + k) % nWorkers];
+                std::lock_guard<std::mutex> Lock(D.Mutex);
+                if (D.Tasks.empty())
+                    continue;
+
+                if (k == 0) { t = D.Tasks.front(); D.Tasks.pop_front(); } // own deque
+                else        { t = D.Tasks.back (); D.Tasks.pop_back (); } // steal
+                bTask = true;
+            }
+
+            if (!bTask) // tasks are not added while running, so all deques are empty
+                return;
+
+            f(t, unsigned(w));
+        }
+    });
+}
+
+// ==========================================================================
+// parallel sort of floating-point values (ascending), using nThreads threads
+// the array is split into nThreads runs, which are sorted concurrently, and then merged pairwise.
+// each merge is split into independent parts (along its merge path), so all threads work in all rounds
+// tmp is a scratch buffer. on return, v holds the sorted values
+inline void ParallelSort(std::vector<double>& v, std::vector<double>& tmp, unsigned nThreads)
+{
+    const size_t n = v.size();
+    if (nThreads <= 1 || n < 65536)
+    {
+        std::sort(v.begin(), v.end());
+        return;
+    }
+
+    // runs: [Bounds[r], Bounds[r+1])
+    std::vector<size_t> Bounds(nThreads + 1);
+    for (size_t t = 0; t <= nThreads; ++t)
+        Bounds[t] = n * t / nThreads;
+
+    ParallelRun(nThreads, [&](size_t t) { std::sort(v.begin() + Bounds[t], v.begin() + Bounds[t+1]); });
+
+    tmp.resize(n);
+    while (Bounds.size() > 2)
+    {
+        const size_t nRuns  = Bounds.size() - 1;
+        const size_t nPairs = (nRuns + 1) / 2;
+        const size_t nParts = std::max<size_t>(1, nThreads / nPairs); // parts per merge
+
+        ParallelRun(nPairs * nParts, [&](size_t t)
+        {
+            const size_t  p = t / nParts, k = t % nParts;
+            const double* A = v.data() + Bounds[2*p];                           // 1st run
+            const double* B = v.data() + Bounds[std::min(2*p+1, nRuns)];        // 2nd run (may be empty)
+            const size_t  na = B - A, nb = Bounds[std::min(2*p+2, nRuns)] - Bounds[std::min(2*p+1, nRuns)];
+
+            // split point on diagonal d of the merge path: i values from A, d-i values from B
+            auto Split = [&](size_t d) -> size_t
+            {
+                size_t lo = d > nb ? d - nb : 0, hi = std::min(d, na);
+                while (lo < hi)
+                {
+                    const size_t mid = (lo + hi) / 2;
+                    if (A[mid] <= B[d - mid - 1]) lo = mid + 1;
+                    else                          hi = mid;
+                }
+                return lo;
+            };
+
+            const size_t d0 = (na + nb) * k / nParts, d1 = (na + nb) * (k+1) / nParts;
+            const size_t i0 = Split(d0), i1 = Split(d1);
+            std::merge(A + i0, A + i1, B + (d0 - i0), B + (d1 - i1), tmp.data() + Bounds[2*p] + d0);
+        });
+
+        v.swap(tmp);
+
+        std::vector<size_t> Merged; // bounds of merged runs
+        for (size_t r = 0; r < nRuns; r += 2)
+            Merged.emplace_back(Bounds[r]);
+        Merged.emplace_back(n);
+        Bounds.swap(Merged);
+    }
+}
@@ -0,0 +1,326 @@
+// ==========================================================================
+// Copyright (C) 2026 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+// functions defined here:
+// SimdMulSub             - x - y*z, fused where the target has a hardware FMA (as MulSub)
+// SimdWrap               - wrap contiguous floating-point values to [L,H) (AVX-512 / AVX2 kernels)
+// SimdWrapNearest        - wrap contiguous floating-point values to [L,H) by rounding to the nearest multiple of the range
+// SimdSinCos             - sine and cosine of contiguous circular values (quadrant-based reduction, Cephes polynomials)
+//
+// the kernels are selected at compile time (__AVX512F__, __AVX2__).
+// when no kernel is available, the functions process no values, and the caller falls back to the scalar path.
+// the wrap kernels fuse their multiply-subtract exactly where the scalar Wrap does (SimdMulSub, MulSub: where the
+// target has a hardware FMA), so their results are identical to the scalar path whether or not the compiler contracts
+// floating-point expressions. SimdSinCos uses explicit multiply/add (no FMA), so its results are identical to the
+// scalar path as long as the scalar path is not compiled with floating-point contraction
+// ==========================================================================
+
+#pragma once
+
+#include <cstddef>         // size_t
+#include <initializer_list>
+
+#include "CircHelper.h"    // CIRCULAR_FMA, MulSub
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ==========================================================================
+// number of doubles processed by a single SIMD operation (1: no SIMD kernel)
+#if   defined(__AVX512F__)
+constexpr size_t SimdWidth = 8;
+#elif defined(__AVX2__)
+constexpr size_t SimdWidth = 4;
+#else
+constexpr size_t SimdWidth = 1;
+#endif
+
+// ==========================================================================
+// x - y*z, lane-wise identical to MulSub: fused where the target has a hardware FMA
+#if defined(__AVX512F__)
+inline __m512d SimdMulSub(__m512d x, __m512d y, __m512d z)
+{
+#if CIRCULAR_FMA
+    return _mm512_fnmadd_pd(y, z, x);
+#else
+    return _mm512_sub_pd(x, _mm512_mul_pd(y, z));
+#endif
+}
+#elif defined(__AVX2__)
+inline __m256d SimdMulSub(__m256d x, __m256d y, __m256d z)
+{
+#if CIRCULAR_FMA
+    return _mm256_fnmadd_pd(y, z, x);
+#else
+    return _mm256_sub_pd(x, _mm256_mul_pd(y, z));
+#endif
+}
+#endif
+
+// ==========================================================================
+// wrap in[0..n) to [L,H), R= H-L > 0. in and out may be the same array
+// lane-wise identical to CircVal<Type>::Wrap (including the boundary fixups of Mod)
+// return number of processed values (a multiple of SimdWidth); the caller should wrap the remaining values
+inline size_t SimdWrap([[maybe_unused]] const double* in, [[maybe_unused]] double* out, [[maybe_unused]] size_t n,
+                       [[maybe_unused]] double L, [[maybe_unused]] double H, [[maybe_unused]] double R)
+{
+    size_t i = 0;
+
+#if defined(__AVX512F__)
+    const __m512d vL   = _mm512_set1_pd(L    );
+    const __m512d vH   = _mm512_set1_pd(H    );
+    const __m512d vR   = _mm512_set1_pd(R    );
+    const __m512d vHR  = _mm512_set1_pd(H + R); // upper bound of 'r-R' fast path
+    const __m512d vLR  = _mm512_set1_pd(L - R); // lower bound of 'r+R' fast path
+    const __m512d vZ   = _mm512_setzero_pd(  );
+
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m512d r = _mm512_loadu_pd(in + i);
+
+        // general case: Mod(r-L, R) + L
+        const __m512d x  = _mm512_sub_pd(r, vL);
+        const __m512d q  = _mm512_maskz_roundscale_pd(0xFF, _mm512_div_pd(x, vR), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); // floor
+              __m512d m  = SimdMulSub(x, vR, q);
+
+        m = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(m, vR, _CMP_GE_OQ), m, vZ);         // m >= y  : 0
+
+        const __m512d  ym   = _mm512_add_pd(vR, m);
+        const __mmask8 neg  = _mm512_cmp_pd_mask(m , vZ, _CMP_LT_OQ);                    // m <  0  : y+m
+        const __mmask8 same = _mm512_cmp_pd_mask(ym, vR, _CMP_EQ_OQ);                    // y+m == y: 0
+        m = _mm512_mask_blend_pd(neg, m, _mm512_mask_blend_pd(same, ym, vZ));
+
+        __m512d res = _mm512_add_pd(m, vL);
+
+        // fast paths (in reverse order of precedence)
+        const __mmask8 ge   = _mm512_cmp_pd_mask(r, vL , _CMP_GE_OQ);
+        const __mmask8 ltH  = _mm512_cmp_pd_mask(r, vH , _CMP_LT_OQ);
+        const __mmask8 ltHR = _mm512_cmp_pd_mask(r, vHR, _CMP_LT_OQ);
+        const __mmask8 geLR = _mm512_cmp_pd_mask(r, vLR, _CMP_GE_OQ);
+        const __mmask8 lt   = _mm512_cmp_pd_mask(r, vL , _CMP_NGE_UQ); // !(r >= L)
+
+        const __m512d rR = _mm512_add_pd(r, vR);
+        res = _mm512_mask_blend_pd(lt &  geLR       , res, _mm512_mask_blend_pd(_mm512_cmp_pd_mask(rR, vH, _CMP_LT_OQ), vL, rR)); // r in [L-R,L  ): r+R (L if rounded to H)
+        res = _mm512_mask_blend_pd(ge & ~ltH & ltHR , res, _mm512_sub_pd(r, vR)); // r in [H  ,H+R): r-R
+        res = _mm512_mask_blend_pd(ge &  ltH        , res, r                    ); // r in [L  ,H  ): r
+
+        _mm512_storeu_pd(out + i, res);
+    }
+
+#elif defined(__AVX2__)
+    const __m256d vL   = _mm256_set1_pd(L    );
+    const __m256d vH   = _mm256_set1_pd(H    );
+    const __m256d vR   = _mm256_set1_pd(R    );
+    const __m256d vHR  = _mm256_set1_pd(H + R); // upper bound of 'r-R' fast path
+    const __m256d vLR  = _mm256_set1_pd(L - R); // lower bound of 'r+R' fast path
+    const __m256d vZ   = _mm256_setzero_pd(  );
+
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256d r = _mm256_loadu_pd(in + i);
+
+        // general case: Mod(r-L, R) + L
+        const __m256d x  = _mm256_sub_pd(r, vL);
+        const __m256d q  = _mm256_floor_pd(_mm256_div_pd(x, vR));
+              __m256d m  = SimdMulSub(x, vR, q);
+
+        m = _mm256_blendv_pd(m, vZ, _mm256_cmp_pd(m, vR, _CMP_GE_OQ));                   // m >= y  : 0
+
+        const __m256d ym   = _mm256_add_pd(vR, m);
+        const __m256d neg  = _mm256_cmp_pd(m , vZ, _CMP_LT_OQ);                          // m <  0  : y+m
+        const __m256d same = _mm256_cmp_pd(ym, vR, _CMP_EQ_OQ);                          // y+m == y: 0
+        m = _mm256_blendv_pd(m, _mm256_blendv_pd(ym, vZ, same), neg);
+
+        __m256d res = _mm256_add_pd(m, vL);
+
+        // fast paths (in reverse order of precedence)
+        const __m256d ge   = _mm256_cmp_pd(r, vL , _CMP_GE_OQ);
+        const __m256d ltH  = _mm256_cmp_pd(r, vH , _CMP_LT_OQ);
+        const __m256d ltHR = _mm256_cmp_pd(r, vHR, _CMP_LT_OQ);
+        const __m256d geLR = _mm256_cmp_pd(r, vLR, _CMP_GE_OQ);
+        const __m256d lt   = _mm256_cmp_pd(r, vL , _CMP_NGE_UQ); // !(r >= L)
+
+        const __m256d rR = _mm256_add_pd(r, vR);
+        res = _mm256_blendv_pd(res, _mm256_blendv_pd(vL, rR, _mm256_cmp_pd(rR, vH, _CMP_LT_OQ)),
+                                                          _mm256_and_pd(lt, geLR                        )); // r in [L-R,L  ): r+R (L if rounded to H)
+        res = _mm256_blendv_pd(res, _mm256_sub_pd(r, vR), _mm256_and_pd(ge, _mm256_andnot_pd(ltH, ltHR))); // r in [H  ,H+R): r-R
+        res = _mm256_blendv_pd(res, r                   , _mm256_and_pd(ge, ltH                         )); // r in [L  ,H  ): r
+
+        _mm256_storeu_pd(out + i, res);
+    }
+#endif
+
+    return i;
+}
+
+// ==========================================================================
+// wrap in[0..n) to [L,H), R= H-L > 0, C= (L+H)/2, InvR= 1/R: r - RoundNearest((r-C)*InvR)*R, then the boundary fixups.
+// in and out may be the same array
+// lane-wise identical to CircVal<Type>::Wrap of the [0,R) and [-R/2,R/2) ranges (CircVal<>::NearestWrap)
+// return number of processed values (a multiple of SimdWidth); the caller should wrap the remaining values
+inline size_t SimdWrapNearest([[maybe_unused]] const double* in, [[maybe_unused]] double* out, [[maybe_unused]] size_t n,
+                              [[maybe_unused]] double L, [[maybe_unused]] double H, [[maybe_unused]] double R,
+                              [[maybe_unused]] double C, [[maybe_unused]] double InvR)
+{
+    size_t i = 0;
+
+#if defined(__AVX512F__)
+    const __m512d vL     = _mm512_set1_pd(L       );
+    const __m512d vH     = _mm512_set1_pd(H       );
+    const __m512d vR     = _mm512_set1_pd(R       );
+    const __m512d vC     = _mm512_set1_pd(C       );
+    const __m512d vInvR  = _mm512_set1_pd(InvR    );
+    const __m512d vMagic = _mm512_set1_pd(0x1.8p52);
+    const __m512d vBig   = _mm512_set1_pd(0x1p51  );
+
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m512d r = _mm512_loadu_pd(in + i);
+        const __m512d x = _mm512_mul_pd(_mm512_sub_pd(r, vC), vInvR);
+        const __m512d q = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(_mm512_abs_pd(x), vBig, _CMP_LT_OQ), x,
+                                               _mm512_sub_pd(_mm512_add_pd(x, vMagic), vMagic));          // RoundNearest(x)
+              __m512d m = SimdMulSub(r, q, vR);
+
+        m = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(m, vL, _CMP_LT_OQ), m, _mm512_add_pd(m, vR)); // m <  L: m+R
+        m = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(m, vH, _CMP_GE_OQ), m, _mm512_sub_pd(m, vR)); // m >= H: m-R
+
+        _mm512_storeu_pd(out + i, m);
+    }
+
+#elif defined(__AVX2__)
+    const __m256d vL     = _mm256_set1_pd(L       );
+    const __m256d vH     = _mm256_set1_pd(H       );
+    const __m256d vR     = _mm256_set1_pd(R       );
+    const __m256d vC     = _mm256_set1_pd(C       );
+    const __m256d vInvR  = _mm256_set1_pd(InvR    );
+    const __m256d vMagic = _mm256_set1_pd(0x1.8p52);
+    const __m256d vBig   = _mm256_set1_pd(0x1p51  );
+    const __m256d vSign  = _mm256_set1_pd(-0.     );
+
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256d r = _mm256_loadu_pd(in + i);
+        const __m256d x = _mm256_mul_pd(_mm256_sub_pd(r, vC), vInvR);
+        const __m256d q = _mm256_blendv_pd(x, _mm256_sub_pd(_mm256_add_pd(x, vMagic), vMagic),
+                                           _mm256_cmp_pd(_mm256_andnot_pd(vSign, x), vBig, _CMP_LT_OQ));  // RoundNearest(x)
+              __m256d m = SimdMulSub(r, q, vR);
+
+        m = _mm256_blendv_pd(m, _mm256_add_pd(m, vR), _mm256_cmp_pd(m, vL, _CMP_LT_OQ));        // m <  L: m+R
+        m = _mm256_blendv_pd(m, _mm256_sub_pd(m, vR), _mm256_cmp_pd(m, vH, _CMP_GE_OQ));        // m >= H: m-R
+
+        _mm256_storeu_pd(out + i, m);
+    }
+#endif
+
+    return i;
+}
+
+// ==========================================================================
+// sine and cosine of the angles (in[i]-Z)*Scale radians, i in [0..n): SinCosQuadrant (CircHelper.h) of in[i]-Z
+// lane-wise identical to SinCosQuadrant: the same operations in the same order (the polynomials' subtractions are
+// additions of the negated coefficients - which are exact negations)
+// return number of processed values (a multiple of SimdWidth); the caller should process the remaining values
+inline size_t SimdSinCos([[maybe_unused]] const double* in, [[maybe_unused]] double* s, [[maybe_unused]] double* c, [[maybe_unused]] size_t n,
+                         [[maybe_unused]] double Z , [[maybe_unused]] double InvQ, [[maybe_unused]] double Q1, [[maybe_unused]] double Q2,
+                         [[maybe_unused]] double Q3, [[maybe_unused]] double Scale)
+{
+    size_t i = 0;
+
+#if defined(__AVX512F__)
+    const __m512d vZ     = _mm512_set1_pd(Z       );
+    const __m512d vInvQ  = _mm512_set1_pd(InvQ    );
+    const __m512d vQ1    = _mm512_set1_pd(Q1      );
+    const __m512d vQ2    = _mm512_set1_pd(Q2      );
+    const __m512d vQ3    = _mm512_set1_pd(Q3      );
+    const __m512d vScale = _mm512_set1_pd(Scale   );
+    const __m512d vMagic = _mm512_set1_pd(0x1.8p52);
+    const __m512d vOne   = _mm512_set1_pd(1.      );
+    const __m512d vHalf  = _mm512_set1_pd(0.5     );
+    const __m512i nOne   = _mm512_set1_epi64(1    );
+    const __m512i nTwo   = _mm512_set1_epi64(2    );
+
+    auto Poly = [](__m512d z, std::initializer_list<double> Coef) // Horner: ((c0*z + c1)*z + c2)...
+    {
+        const double* p = Coef.begin();
+        __m512d       a = _mm512_set1_pd(*p);
+        while (++p != Coef.end())
+            a = _mm512_add_pd(_mm512_mul_pd(a, z), _mm512_set1_pd(*p));
+        return a;
+    };
+
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m512d v = _mm512_sub_pd(_mm512_loadu_pd(in + i), vZ);
+        const __m512d k = _mm512_add_pd(_mm512_mul_pd(v, vInvQ), vMagic);
+        const __m512d q = _mm512_sub_pd(k, vMagic);
+        const __m512d r = _mm512_sub_pd(_mm512_sub_pd(_mm512_sub_pd(v, _mm512_mul_pd(q, vQ1)), _mm512_mul_pd(q, vQ2)), _mm512_mul_pd(q, vQ3));
+        const __m512d x = _mm512_mul_pd(r, vScale);
+        const __m512d z = _mm512_mul_pd(x, x);
+
+        const __m512d s0 = _mm512_add_pd(x, _mm512_mul_pd(_mm512_mul_pd(x, z),
+                                         Poly(z, { 1.58962301576546568060E-10, -2.50507477628578072866E-8, 2.75573136213857245213E-6,
+                                                  -1.98412698295895385996E-4,  8.33333333332211858878E-3, -1.66666666666666307295E-1 })));
+        const __m512d c0 = _mm512_add_pd(_mm512_sub_pd(vOne, _mm512_mul_pd(vHalf, z)), _mm512_mul_pd(_mm512_mul_pd(z, z),
+                                         Poly(z, {-1.13585365213876817300E-11,  2.08757008419747316778E-9, -2.75573141792967388112E-7,
+                                                   2.48015872888517045348E-5, -1.38888888888730564116E-3,  4.16666666666665929218E-2 })));
+
+        const __m512i  nq    = _mm512_castpd_si512(k);
+        const __mmask8 bSwap = _mm512_test_epi64_mask(nq, nOne);
+        const __m512i  sS    = _mm512_slli_epi64(_mm512_and_si512(nq, nTwo), 62);
+        const __m512i  sC    = _mm512_slli_epi64(_mm512_and_si512(_mm512_add_epi64(nq, nOne), nTwo), 62);
+
+        _mm512_storeu_pd(s + i, _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(_mm512_mask_blend_pd(bSwap, s0, c0)), sS)));
+        _mm512_storeu_pd(c + i, _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(_mm512_mask_blend_pd(bSwap, c0, s0)), sC)));
+    }
+
+#elif defined(__AVX2__)
+    const __m256d vZ     = _mm256_set1_pd(Z       );
+    const __m256d vInvQ  = _mm256_set1_pd(InvQ    );
+    const __m256d vQ1    = _mm256_set1_pd(Q1      );
+    const __m256d vQ2    = _mm256_set1_pd(Q2      );
+    const __m256d vQ3    = _mm256_set1_pd(Q3      );
+    const __m256d vScale = _mm256_set1_pd(Scale   );
+    const __m256d vMagic = _mm256_set1_pd(0x1.8p52);
+    const __m256d vOne   = _mm256_set1_pd(1.      );
+    const __m256d vHalf  = _mm256_set1_pd(0.5     );
+    const __m256i nOne   = _mm256_set1_epi64x(1   );
+    const __m256i nTwo   = _mm256_set1_epi64x(2   );
+
+    auto Poly = [](__m256d z, std::initializer_list<double> Coef) // Horner: ((c0*z + c1)*z + c2)...
+    {
+        const double* p = Coef.begin();
+        __m256d       a = _mm256_set1_pd(*p);
+        while (++p != Coef.end())
+            a = _mm256_add_pd(_mm256_mul_pd(a, z), _mm256_set1_pd(*p));
+        return a;
+    };
+
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256d v = _mm256_sub_pd(_mm256_loadu_pd(in + i), vZ);
+        const __m256d k = _mm256_add_pd(_mm256_mul_pd(v, vInvQ), vMagic);
+        const __m256d q = _mm256_sub_pd(k, vMagic);
+        const __m256d r = _mm256_sub_pd(_mm256_sub_pd(_mm256_sub_pd(v, _mm256_mul_pd(q, vQ1)), _mm256_mul_pd(q, vQ2)), _mm256_mul_pd(q, vQ3));
+        const __m256d x = _mm256_mul_pd(r, vScale);
+        const __m256d z = _mm256_mul_pd(x, x);
+
+        const __m256d s0 = _mm256_add_pd(x, _mm256_mul_pd(_mm256_mul_pd(x, z),
+                                         Poly(z, { 1.58962301576546568060E-10, -2.50507477628578072866E-8, 2.75573136213857245213E-6,
+                                                  -1.98412698295895385996E-4,  8.33333333332211858878E-3, -1.66666666666666307295E-1 })));
+        const __m256d c0 = _mm256_add_pd(_mm256_sub_pd(vOne, _mm256_mul_pd(vHalf, z)), _mm256_mul_pd(_mm256_mul_pd(z, z),
+                                         Poly(z, {-1.13585365213876817300E-11,  2.08757008419747316778E-9, -2.75573141792967388112E-7,
+                                                   2.48015872888517045348E-5, -1.38888888888730564116E-3,  4.16666666666665929218E-2 })));
+
+        const __m256i nq    = _mm256_castpd_si256(k);
+        const __m256d bSwap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(nq, nOne), nOne));
+        const __m256i sS    = _mm256_slli_epi64(_mm256_and_si256(nq, nTwo), 62);
+        const __m256i sC    = _mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi64(nq, nOne), nTwo), 62);
+
+        _mm256_storeu_pd(s + i, _mm256_xor_pd(_mm256_blendv_pd(s0, c0, bSwap), _mm256_castsi256_pd(sS)));
+        _mm256_storeu_pd(c + i, _mm256_xor_pd(_mm256_blendv_pd(c0, s0, bSwap), _mm256_castsi256_pd(sC)));
+    }
+#endif
+
+    return i;
+}
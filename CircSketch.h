@@ -0,0 +1,735 @@
+// ==========================================================================
+// Copyright (C) 2026 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+// classes defined here:
+// CircAverageSketch  - mergeable sufficient-statistics summary of circular values, for calculating the average set (distributed CircAverage)
+// CircQuantileSketch - mergeable bounded-memory streaming summary of circular values, for estimating the median and quantiles
+// CircSketchTester   - tester for the above
+// ==========================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <bit>                // bit_cast, bit_width
+#include <vector>
+#include <set>
+#include <span>
+#include <random>
+#include <stdexcept>          // logic_error, runtime_error
+#include <algorithm>          // min, max, sort
+#include <cmath>              // sqrt, log, ceil
+#include <assert.h>
+
+#include "CircVal.h"          // CircVal
+#include "CircHelper.h"       // Sqr, Mod
+#include "CircStat.h"         // CircAverage2, ShiftSumSqrDiff, CircMeanResultantState, CircMedian
+#include "PhiloxEngine.h"     // PhiloxEngine
+
+// ==========================================================================
+// mergeable summary of a collection of circular values, for calculating the average set (as CircAverage2) - e.g. of
+// values sharded across processes: each shard summarizes its values, the summaries are merged (Merge), or serialized
+// (Serialize) and sent to a reducer. memory and serialized size are O(buckets), independent of the number of values.
+//
+// the circle ([0,360) - as CircAverage2) is divided into nBuckets buckets of width w= 360/nBuckets. per bucket:
+// the number of values, their sum and their sum of squares. these are the sufficient statistics of CircAverage2 for
+// the shifts at the bucket boundaries: GetAvrg sweeps over these shifts (as CircAverageSorted sweeps over the shifts
+// between the sorted values), and returns the set of averages of minimal sum of squares of differences.
+//
+// error bound: let a be an average of CircAverage2 (of the same values), F(x) the sum of squared arc distances from x,
+// and n_j the number of values in the bucket containing the antipode of a. for any average s of GetAvrg:
+//     F(s) <= F(a) + 2*R*w*n_j           (R, w in the units of T: w= T::R/nBuckets)
+// the shifts of CircAverage2 and of the nearest bucket boundary differ only by the values of that bucket - which are
+// within w of the antipode, so each adds at most (R/2+w)^2-(R/2-w)^2 = 2*R*w. when that bucket is empty (e.g. values
+// concentrated within half a circle minus w), the shifts are the same: the average set contains a (up to rounding).
+// SumSqrDiffErrorBound() is the bound for the fullest bucket: 2*R*w*max(n_j)
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+class CircAverageSketch
+{
+    struct Bucket // values in UnsignedDegRange [0,360)
+    {
+        uint64_t n       = 0 ;
+        double   fSum    = 0.;
+        double   fSumSqr = 0.;
+    };
+
+    vector<Bucket> m_Buckets;
+    uint64_t       m_Count = 0;
+
+    size_t Index(double x) const // x in [0,360)
+    {
+        return min(m_Buckets.size() - 1, size_t(x * (double(m_Buckets.size()) / 360.)));
+    }
+
+    // ---------------------------------------------
+    // serialization: unsigned LEB128 varints, and doubles as 8 little-endian bytes
+    static void PutVarint(vector<uint8_t>& Out, uint64_t v)
+    {
+        for (; v >= 0x80; v >>= 7)
+            Out.push_back(uint8_t(v | 0x80));
+        Out.push_back(uint8_t(v));
+    }
+
+    static void PutDouble(vector<uint8_t>& Out, double f)
+    {
+        const uint64_t v = bit_cast<uint64_t>(f);
+        for (unsigned i = 0; i < 8; ++i)
+            Out.push_back(uint8_t(v >> (8 * i)));
+    }
+
+    static uint64_t GetVarint(span<const uint8_t> In, size_t& i)
+    {
+        uint64_t v = 0;
+        for (unsigned nShift = 0; nShift < 64; nShift += 7)
+        {
+            if (i >= In.size())
+                throw runtime_error("CircAverageSketch: truncated blob");
+
+            const uint8_t b = In[i++];
+            v |= uint64_t(b & 0x7F) << nShift;
+            if (!(b & 0x80))
+                return v;
+        }
+
+        throw runtime_error("CircAverageSketch: invalid varint");
+    }
+
+    static double GetDouble(span<const uint8_t> In, size_t& i)
+    {
+        if (In.size() - i < 8)
+            throw runtime_error("CircAverageSketch: truncated blob");
+
+        uint64_t v = 0;
+        for (unsigned k = 0; k < 8; ++k)
+            v |= uint64_t(In[i++]) << (8 * k);
+        return bit_cast<double>(v);
+    }
+
+    static constexpr uint8_t FormatVersion = 1;
+
+public:
+    static constexpr size_t MaxBuckets = size_t(1) << 24;
+
+private:
+    static size_t ValidBucketCount(size_t nBuckets)
+    {
+        if (nBuckets == 0 || nBuckets > MaxBuckets)
+            throw logic_error("CircAverageSketch: nBuckets should be in [1,MaxBuckets]");
+        return nBuckets;
+    }
+
+public:
+    explicit CircAverageSketch(size_t nBuckets = 1024) : m_Buckets(ValidBucketCount(nBuckets))
+    {
+    }
+
+    template<typename Real>
+    void Add(const CircVal<T, Real>& c)
+    {
+        const double x = CircVal<UnsignedDegRange>(c); // convert to [0,360)
+        Bucket&      B = m_Buckets[Index(x)];
+
+        ++B.n;
+        B.fSum    +=     x ;
+        B.fSumSqr += Sqr(x);
+        ++m_Count;
+    }
+
+    template<typename Real>
+    void Add(span<const CircVal<T, Real>> A)
+    {
+        for (const auto& a : A)
+            Add(a);
+    }
+
+    template<typename Real>
+    void Add(vector<CircVal<T, Real>> const& A)
+    {
+        Add(span<const CircVal<T, Real>>(A));
+    }
+
+    // add the values of another sketch (of the same number of buckets)
+    void Merge(const CircAverageSketch& Other)
+    {
+        if (Other.m_Buckets.size() != m_Buckets.size())
+            throw logic_error("CircAverageSketch: merged sketches should have the same number of buckets");
+
+        for (size_t k = 0; k < m_Buckets.size(); ++k)
+        {
+            m_Buckets[k].n       += Other.m_Buckets[k].n      ;
+            m_Buckets[k].fSum    += Other.m_Buckets[k].fSum   ;
+            m_Buckets[k].fSumSqr += Other.m_Buckets[k].fSumSqr;
+        }
+
+        m_Count += Other.m_Count;
+    }
+
+    void     Clear      ()       { m_Buckets.assign(m_Buckets.size(), Bucket()); m_Count = 0; }
+    uint64_t Count      () const { return m_Count;                                            }
+    size_t   BucketCount() const { return m_Buckets.size();                                   }
+    double   BucketWidth() const { return T::R / double(m_Buckets.size());                    } // in the units of T
+
+    // bound of F(s) - F(a) for the fullest bucket (see above), in the units of T squared
+    double SumSqrDiffErrorBound() const
+    {
+        uint64_t nMax = 0;
+        for (const Bucket& B : m_Buckets)
+            nMax = max(nMax, B.n);
+
+        return 2. * T::R * BucketWidth() * double(nMax);
+    }
+
+    // return set of average values (empty set if no values were added)
+    set<CircVal<T>> GetAvrg() const
+    {
+        set<CircVal<T>> MinAvrgCircVals;
+        GetAvrg(MinAvrgCircVals);
+        return MinAvrgCircVals;
+    }
+
+    // get set of average values (set<CircVal<T>> or CircValSmallSet<T>)
+    template<typename ResultSet>
+    void GetAvrg(ResultSet& MinAvrgCircVals) const
+    {
+        MinAvrgCircVals.clear();
+        if (m_Count == 0)
+            return;
+
+        const size_t count   = size_t(m_Count);
+        double       fSum    = 0.;
+        double       fSumSqr = 0.;
+        for (const Bucket& B : m_Buckets)
+        {
+            fSum    += B.fSum   ;
+            fSumSqr += B.fSumSqr;
+        }
+
+        // avrg from shift (number of shifted values)
+        auto ShiftAvrg = [&](size_t i) { return CircVal<UnsignedDegRange>((fSum+360.*i) / count); };
+
+        double fMinSumSqrDiff = fSumSqr - Sqr(fSum)/count;
+        MinAvrgCircVals.emplace(ShiftAvrg(0));
+
+        // shift the buckets one by one (as CircAverageSorted shifts the values). shifting all of them is the initial order
+        double fDelta = 0.; // increment of fSumSqr
+        size_t i      = 0 ; // number of shifted values
+        for (const Bucket& B : m_Buckets)
+        {
+            if (B.n == 0)
+                continue;
+
+            fDelta += 720.*B.fSum;
+            i      += size_t(B.n);
+            if (i == count)
+                break;
+
+            const double fTestSumDiffSqr = ShiftSumSqrDiff(fSumSqr + fDelta, fSum, i, count);
+
+            if (fTestSumDiffSqr < fMinSumSqrDiff)       // new minimum found?
+            {
+                MinAvrgCircVals.clear();
+                MinAvrgCircVals.emplace(ShiftAvrg(i));
+                fMinSumSqrDiff = fTestSumDiffSqr;
+            }
+            else if (fTestSumDiffSqr == fMinSumSqrDiff) // same minimum?
+                MinAvrgCircVals.emplace(ShiftAvrg(i));
+        }
+    }
+
+    // ---------------------------------------------
+    // compact binary blob: version, number of buckets, number of nonempty buckets, and per nonempty bucket:
+    // the gap from the previous nonempty bucket, the number of values (varints), the sum and the sum of squares (8 bytes each)
+    vector<uint8_t> Serialize() const
+    {
+        size_t nNonEmpty = 0;
+        for (const Bucket& B : m_Buckets)
+            nNonEmpty += B.n != 0;
+
+        vector<uint8_t> Out;
+        Out.reserve(12 + nNonEmpty * 20);
+
+        Out.push_back(FormatVersion);
+        PutVarint(Out, m_Buckets.size());
+        PutVarint(Out, nNonEmpty);
+
+        size_t kNext = 0;
+        for (size_t k = 0; k < m_Buckets.size(); ++k)
+        {
+            const Bucket& B = m_Buckets[k];
+            if (B.n == 0)
+                continue;
+
+            PutVarint(Out, k - kNext);
+            PutVarint(Out, B.n);
+            PutDouble(Out, B.fSum);
+            PutDouble(Out, B.fSumSqr);
+            kNext = k + 1;
+        }
+
+        return Out;
+    }
+
+    // throws runtime_error if the blob is malformed
+    static CircAverageSketch Deserialize(span<const uint8_t> In)
+    {
+        size_t i = 0;
+        if (In.empty() || In[i++] != FormatVersion)
+            throw runtime_error("CircAverageSketch: unknown blob format");
+
+        const uint64_t nBuckets  = GetVarint(In, i);
+        const uint64_t nNonEmpty = GetVarint(In, i);
+        if (nBuckets == 0 || nBuckets > MaxBuckets || nNonEmpty > nBuckets)
+            throw runtime_error("CircAverageSketch: invalid number of buckets");
+
+        CircAverageSketch Sketch((size_t(nBuckets)));
+
+        uint64_t k = 0;
+        for (uint64_t j = 0; j < nNonEmpty; ++j, ++k)
+        {
+            k += GetVarint(In, i);
+            if (k >= nBuckets)
+                throw runtime_error("CircAverageSketch: invalid bucket index");
+
+            Bucket& B = Sketch.m_Buckets[size_t(k)];
+            B.n       = GetVarint(In, i);
+            B.fSum    = GetDouble(In, i);
+            B.fSumSqr = GetDouble(In, i);
+            if (B.n == 0)
+                throw runtime_error("CircAverageSketch: empty bucket");
+
+            Sketch.m_Count += B.n;
+        }
+
+        if (i != In.size())
+            throw runtime_error("CircAverageSketch: trailing bytes");
+
+        return Sketch;
+    }
+};
+
+// ==========================================================================
+// mergeable streaming summary of circular values, for estimating the median and quantiles (e.g. p5/p95 of headings)
+// over unbounded streams, in bounded memory: O(k) values
+//
+// quantiles of circular values are defined by a cut point: the values are ordered by their signed distance from the mean,
+// Sdist(Mean, x) in [-R/2,R/2) - the cut is the antipode of the mean. the mean is the conventional (atan2) mean of all
+// the values added (an exact running sum - CircMeanResultantState), so the cut adapts to the stream. the rank of x is the
+// number of values y with Sdist(Mean, y) < Sdist(Mean, x), and the q-quantile is a value of rank q*n.
+// for values within an arc shorter than half a circle, the 0.5-quantile is a median of CircMedian
+//
+// a hierarchy of compactors (as the KLL sketch): level h holds values of weight 2^h. the capacity of the top level is k,
+// and the capacities decrease geometrically down the levels (by 2/3 per level, and at least 2), so at most ~3k values
+// are stored. when a level reaches its capacity, its values are sorted, and every other value (odd or even positions -
+// a random offset) moves to level h+1 with twice the weight.
+// the values of any arc of the circle are a cyclic run of the sorted values, so a compaction at level h changes the
+// weight of the values of any arc by at most 2^h - and by 0 on average (the offset is random). so for any arc:
+// - always                                   : |rank error| <= sum over the compactions of 2^h        (RankErrorBound())
+// - with probability >= 1-delta (Hoeffding)  : |rank error| <= sqrt(2*ln(2/delta) * sum of 4^h)       (RankErrorBound(delta))
+// since the cut depends only on the values (not on the random offsets), these bounds hold for the ranks from the cut.
+// the q-quantile estimate x satisfies |rank(x) - q*n| <= the rank error bound + MaxWeight() (the weight of a stored value)
+// e.g. k= 1024, n= 10^6 values: about 2100 stored values; rank error bounds 10% of n (always), 0.77% of n (delta= 10^-9)
+//
+// sketches of shards of a stream should use the same seed and distinct streams (PhiloxEngine): independent offsets
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+class CircQuantileSketch
+{
+    size_t                    m_k           ; // capacity of the top level (even)
+    vector<vector<double>>    m_Levels      ; // level h: values of weight 2^h
+    vector<size_t>            m_Capacities  ; // per level: about k*(2/3)^(top-h), even, at least 2
+    vector<uint64_t>          m_nCompactions; // per level
+    CircMeanResultantState<T> m_Mean        ; // of all the values added: the cut is its antipode
+    PhiloxEngine              m_Engine      ; // random offsets of the compactions
+
+    static size_t ValidCapacity(size_t k)
+    {
+        if (k < 2 || k % 2 != 0)
+            throw logic_error("CircQuantileSketch: k should be even and at least 2");
+        return k;
+    }
+
+    // set the level capacities for the current number of levels
+    void SetCapacities()
+    {
+        const size_t nTop = m_Levels.size() - 1;
+        m_Capacities.resize(m_Levels.size());
+
+        double fCap = double(m_k);
+        for (size_t h = nTop + 1; h-- > 0; fCap *= 2. / 3.)
+            m_Capacities[h] = max(size_t(2), 2 * size_t(ceil(fCap / 2.)));
+    }
+
+    void AddLevels(size_t nLevels)
+    {
+        m_Levels      .resize(nLevels);
+        m_nCompactions.resize(nLevels);
+        SetCapacities();
+    }
+
+    // compact level h: sort, and move the values at the odd or even positions to level h+1 (an odd value remains)
+    void Compact(size_t h)
+    {
+        if (h + 1 == m_Levels.size())
+            AddLevels(h + 2);
+
+        vector<double>& L = m_Levels[h  ];
+        vector<double>& U = m_Levels[h+1];
+
+        sort(L.begin(), L.end());
+
+        const size_t m = L.size() & ~size_t(1); // compacted values
+        for (size_t i = m_Engine() & 1; i < m; i += 2)
+            U.push_back(L[i]);
+
+        L.erase(L.begin(), L.begin() + m);
+        ++m_nCompactions[h];
+    }
+
+    // compact the levels which reached their capacities. a new top level decreases the capacities of the levels below it
+    void CompactFull()
+    {
+        for (size_t nLevels = 0; nLevels != m_Levels.size(); )
+        {
+            nLevels = m_Levels.size();
+            for (size_t h = 0; h < m_Levels.size(); ++h)
+                if (m_Levels[h].size() >= m_Capacities[h])
+                    Compact(h);
+        }
+    }
+
+    // stored values with their signed distances from the mean and weights, sorted by the distances
+    struct Item
+    {
+        double   d; // Sdist(Mean, x)
+        double   x;
+        uint64_t w;
+    };
+
+    vector<Item> SortedItems(const CircVal<T>& Mean) const
+    {
+        vector<Item> Items;
+        for (size_t h = 0; h < m_Levels.size(); ++h)
+            for (const double x : m_Levels[h])
+                Items.push_back({ CircVal<T>::Sdist(Mean, x), x, uint64_t(1) << h });
+
+        sort(Items.begin(), Items.end(), [](const Item& a, const Item& b) { return a.d < b.d; });
+        return Items;
+    }
+
+public:
+    explicit CircQuantileSketch(size_t k = 1024, uint64_t nSeed = 0, uint64_t nStream = 0)
+        : m_k(ValidCapacity(k)), m_Levels(1), m_nCompactions(1), m_Engine(nSeed, nStream)
+    {
+        SetCapacities();
+    }
+
+    template<typename Real>
+    void Add(const CircVal<T, Real>& c)
+    {
+        const CircVal<T> v(c);
+        m_Mean.Add(v);
+
+        m_Levels[0].push_back(v);
+        if (m_Levels[0].size() >= m_Capacities[0])
+            CompactFull();
+    }
+
+    template<typename Real>
+    void Add(span<const CircVal<T, Real>> A)
+    {
+        for (const auto& a : A)
+            Add(a);
+    }
+
+    template<typename Real>
+    void Add(vector<CircVal<T, Real>> const& A)
+    {
+        Add(span<const CircVal<T, Real>>(A));
+    }
+
+    // add the values of another sketch (of the same capacity). the rank error bounds add up
+    void Merge(const CircQuantileSketch& Other)
+    {
+        if (Other.m_k != m_k)
+            throw logic_error("CircQuantileSketch: merged sketches should have the same capacity");
+
+        if (m_Levels.size() < Other.m_Levels.size())
+            AddLevels(Other.m_Levels.size());
+
+        for (size_t h = 0; h < Other.m_Levels.size(); ++h)
+        {
+            m_Levels[h].insert(m_Levels[h].end(), Other.m_Levels[h].begin(), Other.m_Levels[h].end());
+            m_nCompactions[h] += Other.m_nCompactions[h];
+        }
+
+        m_Mean.Merge(Other.m_Mean);
+        CompactFull();
+    }
+
+    uint64_t   Count    () const { return m_Mean.Count();                        }
+    size_t     Capacity () const { return m_k;                                   } // of the top level
+    uint64_t   MaxWeight() const { return uint64_t(1) << (m_Levels.size() - 1); } // of a stored value
+    CircVal<T> GetMean  () const { return m_Mean.Get().Mean;                     } // the cut is its antipode
+
+    // number of stored values
+    size_t Size() const
+    {
+        size_t n = 0;
+        for (const auto& L : m_Levels)
+            n += L.size();
+        return n;
+    }
+
+    // bound of the rank error: always (no arguments), or with probability >= 1-fDelta
+    double RankErrorBound() const
+    {
+        double f = 0.;
+        for (size_t h = 0; h < m_nCompactions.size(); ++h)
+            f += double(m_nCompactions[h]) * double(uint64_t(1) << h);
+        return f;
+    }
+
+    double RankErrorBound(double fDelta) const
+    {
+        double fVar = 0.;
+        for (size_t h = 0; h < m_nCompactions.size(); ++h)
+            fVar += double(m_nCompactions[h]) * Sqr(double(uint64_t(1) << h));
+        return min(RankErrorBound(), sqrt(2. * log(2. / fDelta) * fVar));
+    }
+
+    // estimated rank of c: the number of values y with Sdist(Mean, y) < Sdist(Mean, c)
+    double Rank(const CircVal<T>& c) const
+    {
+        const CircVal<T> Mean = GetMean();
+        const double     d    = CircVal<T>::Sdist(Mean, c);
+
+        uint64_t n = 0;
+        for (size_t h = 0; h < m_Levels.size(); ++h)
+            for (const double x : m_Levels[h])
+                n += CircVal<T>::Sdist(Mean, x) < d ? uint64_t(1) << h : 0;
+        return double(n);
+    }
+
+    // estimated q-quantile (q in [0,1]): the stored value at which the cumulative weight (from the cut) reaches q*n
+    CircVal<T> Quantile(double q) const
+    {
+        assert(Count() > 0);
+
+        const vector<Item> Items  = SortedItems(GetMean());
+        const double       fRank  = clamp(q, 0., 1.) * double(Count());
+        uint64_t           nCum   = 0;
+
+        for (const Item& I : Items)
+        {
+            nCum += I.w;
+            if (double(nCum) >= fRank)
+                return I.x;
+        }
+
+        return Items.back().x;
+    }
+
+    CircVal<T> Median() const
+    {
+        return Quantile(0.5);
+    }
+};
+
+// ==========================================================================
+// tester for the sketches
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+class CircSketchTester
+{
+    // sum of squared arc distances from x
+    static double SumSqrDist(const vector<CircVal<T>>& A, const CircVal<T>& x)
+    {
+        double f = 0.;
+        for (const auto& a : A)
+            f += Sqr(CircVal<T>::Sdist(x, a));
+        return f;
+    }
+
+    // slack of the rank asserts: ranks and bounds are exact up to the rounding of their floating-point arithmetic,
+    // which the compiler may contract into fused multiply-adds (e.g. abs(r - q*count) at a zero bound)
+    static constexpr double RankSlack = 1e-9;
+
+public:
+    CircSketchTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        default_random_engine rand_engine;
+        random_device         rnd_device ;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        TestAverageSketch (rand_engine);
+        TestQuantileSketch(rand_engine);
+    }
+
+    // CircAverageSketch vs. CircAverage2: the error bound; merge; serialization
+    static void TestAverageSketch(default_random_engine& rand_engine)
+    {
+        uniform_real_distribution<double> c_uni_dist(T::L, T::H);
+        normal_distribution      <double> n_dist    (0., T::R / 36.);
+
+        for (size_t nBuckets : {1, 2, 7, 64, 1024})
+            for (size_t count : {1, 2, 3, 10, 100, 1000, 10000})
+                for (unsigned t = 0; t < 4; ++t)
+                {
+                    const bool       bConcentrated = t % 2 == 1; // within +-5 standard deviations (50 degrees) of c0
+                    const CircVal<T> c0            = c_uni_dist(rand_engine);
+
+                    vector<CircVal<T>> A(count);
+                    for (auto& a : A)
+                        a = bConcentrated ? c0 + CircVal<T>(T::Z + clamp(n_dist(rand_engine), -T::R / 7.2, T::R / 7.2)) : CircVal<T>(c_uni_dist(rand_engine));
+
+                    CircAverageSketch<T> S(nBuckets);
+                    S.Add(A);
+                    assert(S.Count() == count && S.BucketCount() == nBuckets);
+
+                    const set<CircVal<T>> Exact  = CircAverage2(A);
+                    const set<CircVal<T>> Approx = S.GetAvrg();
+                    assert(!Approx.empty());
+
+                    // F(s) <= F(a) + 2*R*w*n_j; n_j: number of values in the bucket containing the antipode of a
+                    const CircVal<T> a  = *Exact.begin();
+                    const double     Fa = SumSqrDist(A, a);
+                    const size_t     j  = min(nBuckets - 1, size_t(Mod(double(CircVal<UnsignedDegRange>(a)) + 180., 360.) * (double(nBuckets) / 360.)));
+
+                    size_t nj = 0;
+                    for (const auto& x : A)
+                        nj += min(nBuckets - 1, size_t(double(CircVal<UnsignedDegRange>(x)) * (double(nBuckets) / 360.))) == j;
+
+                    for (const auto& s : Approx)
+                    {
+                        const double Fs = SumSqrDist(A, s);
+                        assert(Fs <= Fa + 2. * T::R * S.BucketWidth() * nj + 1e-9 * Sqr(T::R) * count);
+                        assert(Fs <= Fa + S.SumSqrDiffErrorBound()         + 1e-9 * Sqr(T::R) * count);
+                    }
+
+                    // concentrated values, and an empty antipodal bucket: the same average
+                    if (bConcentrated && nj == 0 && nBuckets >= 7)
+                        assert(any_of(Approx.begin(), Approx.end(), [&](const CircVal<T>& s) { return abs(CircVal<T>::Sdist(s, a)) <= T::R * 1e-9; }));
+
+                    // merged sketches of 3 shards: the same counts; sums up to rounding
+                    CircAverageSketch<T> S0(nBuckets), S1(nBuckets), S2(nBuckets);
+                    for (size_t i = 0; i < count; ++i)
+                        (i % 3 == 0 ? S0 : i % 3 == 1 ? S1 : S2).Add(A[i]);
+
+                    S1.Merge(S2);
+                    S0.Merge(S1);
+                    assert(S0.Count() == count);
+                    for (const auto& s : S0.GetAvrg())
+                        assert(SumSqrDist(A, s) <= Fa + S.SumSqrDiffErrorBound() + 1e-9 * Sqr(T::R) * count);
+
+                    // serialization round-trip: the same sketch
+                    const vector<uint8_t>      Blob = S.Serialize();
+                    const CircAverageSketch<T> D    = CircAverageSketch<T>::Deserialize(Blob);
+                    assert(D.Count() == count && D.BucketCount() == nBuckets);
+                    assert(D.GetAvrg() == Approx);
+                    assert(D.Serialize() == Blob);
+                    assert(Blob.size() <= 12 + 20 * min(nBuckets, count));
+                }
+
+        // empty sketch; malformed blobs; mismatching merge
+        CircAverageSketch<T> E(16);
+        assert(E.GetAvrg().empty());
+        assert(CircAverageSketch<T>::Deserialize(E.Serialize()).Count() == 0);
+
+        E.Add(CircVal<T>(T::L));
+        vector<uint8_t> Blob = E.Serialize();
+
+        auto Throws = [](auto f) { try { f(); } catch (const exception&) { return true; } return false; };
+        assert(Throws([&] { CircAverageSketch<T>::Deserialize(span<const uint8_t>(Blob).first(Blob.size() - 1)); }));
+        Blob.push_back(0);
+        assert(Throws([&] { CircAverageSketch<T>::Deserialize(Blob); }));
+        assert(Throws([&] { CircAverageSketch<T>::Deserialize(vector<uint8_t>{ 9 }); }));
+        assert(Throws([&] { E.Merge(CircAverageSketch<T>(8)); }));
+    }
+
+    // CircQuantileSketch vs. the exact ranks (from the sketch's cut) and vs. CircMedian; merge
+    static void TestQuantileSketch(default_random_engine& rand_engine)
+    {
+        uniform_real_distribution<double> c_uni_dist(T::L, T::H);
+        normal_distribution      <double> n_dist    (0., T::R / 36.);
+
+        for (size_t k : {2, 16, 256})
+            for (size_t count : {1, 2, 10, 100, 1000, 10000, 100000})
+                for (unsigned t = 0; t < 2; ++t)
+                {
+                    const bool       bConcentrated = t % 2 == 1; // within +-5 standard deviations (50 degrees) of c0
+                    const CircVal<T> c0            = c_uni_dist(rand_engine);
+
+                    vector<CircVal<T>> A(count);
+                    for (auto& a : A)
+                        a = bConcentrated ? c0 + CircVal<T>(T::Z + clamp(n_dist(rand_engine), -T::R / 7.2, T::R / 7.2)) : CircVal<T>(c_uni_dist(rand_engine));
+
+                    // 3 shards: the same seed, distinct streams
+                    const uint64_t nSeed = rand_engine();
+                    CircQuantileSketch<T> S(k, nSeed), S0(k, nSeed, 1), S1(k, nSeed, 2), S2(k, nSeed, 3);
+                    S.Add(A);
+                    for (size_t i = 0; i < count; ++i)
+                        (i < count / 3 ? S0 : i < count / 2 ? S1 : S2).Add(A[i]);
+
+                    S1.Merge(S2);
+                    S0.Merge(S1);
+
+                    for (const CircQuantileSketch<T>* pS : {&S, &S0})
+                    {
+                        assert(pS->Count() == count);
+                        assert(pS->Size() <= 3 * k + 2 * bit_width(pS->MaxWeight())); // O(k): 2 per level (the minimal capacity) + ~3k
+
+                        const CircVal<T> Mean = pS->GetMean();
+                        vector<double>   D(count); // signed distances from the mean, ascending
+                        for (size_t i = 0; i < count; ++i)
+                            D[i] = CircVal<T>::Sdist(Mean, A[i]);
+                        sort(D.begin(), D.end());
+
+                        auto ExactRank = [&](const CircVal<T>& c) { return double(lower_bound(D.begin(), D.end(), CircVal<T>::Sdist(Mean, c)) - D.begin()); };
+
+                        const double fBound = pS->RankErrorBound();
+                        assert(pS->RankErrorBound(1e-9) <= fBound + RankSlack);
+
+                        for (unsigned i = 0; i < 20; ++i)
+                        {
+                            const CircVal<T> c = c_uni_dist(rand_engine);
+                            assert(abs(pS->Rank(c) - ExactRank(c)) <= fBound + RankSlack);
+                            assert(abs(pS->Rank(c) - ExactRank(c)) <= pS->RankErrorBound(1e-9) + RankSlack);
+                        }
+
+                        for (double q : {0., 0.05, 0.5, 0.95, 1.})
+                        {
+                            const CircVal<T> x = pS->Quantile(q);
+                            const double     r = ExactRank(x);
+                            assert(abs(r - q * count) <= fBound + pS->MaxWeight() + RankSlack);
+                        }
+
+                        // the median of concentrated values: a median of CircMedian (up to the rank error)
+                        if (bConcentrated && count <= 1000)
+                        {
+                            const double r = ExactRank(pS->Median());
+                            for (const auto& m : CircMedian(A))
+                                assert(abs(r - ExactRank(m)) <= fBound + pS->MaxWeight() + 1 + RankSlack);
+                        }
+                    }
+                }
+
+        // exact while no compaction: k > count
+        vector<CircVal<T>> A;
+        for (unsigned i = 0; i < 99; ++i)
+            A.emplace_back(c_uni_dist(rand_engine));
+
+        CircQuantileSketch<T> S(100);
+        S.Add(A);
+        assert(S.RankErrorBound() == 0. && S.MaxWeight() == 1 && S.Size() == 99);
+
+        const CircVal<T> Mean = S.GetMean();
+        vector<CircVal<T>> B(A);
+        sort(B.begin(), B.end(), [&](const CircVal<T>& a, const CircVal<T>& b) { return CircVal<T>::Sdist(Mean, a) < CircVal<T>::Sdist(Mean, b); });
+        assert(S.Median() == B[49] && S.Quantile(0.) == B[0] && S.Quantile(1.) == B[98]);
+    }
+};
@@ -2,10 +2,20 @@
 // Copyright (C) 2011 Lior Kogan (koganlior1@gmail.com)
 // ==========================================================================
 // classes defined here:
+// CircValSmallSet        - small ascendingly sorted set of circular values, used as an allocation-free result set
+// CircStatScratch        - caller-owned scratch buffers for the statistics functions
 // CircAverage            - calculate average set of circular values
+// CircAverageLinear      - calculate average set of circular values, in linear time
+// CircAverageAccumulator - calculate average set of a dynamic collection of circular values
+// CircMeanResultant      - calculate the conventional (atan2) circular mean, mean resultant length, circular variance and standard deviation
+// CircMeanResultantState - mergeable partial state of CircMeanResultant (map-reduce)
 // WeightedCircAverage    - calculate weighted-average set of circular values
 // CAvrgSampledCircSignal - estimate the average of a sampled continuous-time circular signal, using circular linear interpolation
-// CircMedian             - calculate median set of circular values
+// CircMedianBruteForce   - calculate median set of circular values, in O(n^2) - reference implementation
+// CircMedianSorted       - calculate median set of ascendingly sorted circular values, in O(n*log(n))
+// CircMedian             - calculate median set of circular values, in O(n*log(n))
+// CircSlidingWindow      - calculate average set and median set of a sliding window of circular values
+// CircStatTester         - tester for the above
 // ==========================================================================
 
 #pragma once
@@ -13,29 +23,180 @@
 #include <cmath>
 #include <assert.h>
 #include <set>
+#include <array>
 #include <vector>
-#include <algorithm>    // sort
+#include <span>
+#include <memory_resource>    // pmr::unsynchronized_pool_resource
+#include <algorithm>          // sort
 
-#include "CircHelper.h" // Sqr
+#include "CircHelper.h"       // Sqr, RadixSort, CompensatedSum
+#include "CircParallel.h"     // ThreadCount, ParallelRun, ParallelSort
+#include "FPCompare.h"        // IsWithinUlps
 
 using namespace std;
 
 // ==========================================================================
-// calculate average set of circular values
-// return set of average values
+// set of circular values, ascendingly sorted and unique (as std::set), with inline capacity of N values
+// used as an allocation-free result set of the statistics functions: memory is allocated only when the set
+// grows beyond N values (e.g. many ties), and this memory is reused after clear()
+// T is a circular value type defined with the CircValTypeDef macro; Real is the scalar type of the values
+template<typename T, size_t N = 4, typename Real = double>
+class CircValSmallSet
+{
+    array <CircVal<T, Real>, N> m_Inline   ; // values, if m_nSize <= N
+    vector<CircVal<T, Real>   > m_Heap     ; // values, if m_nSize >  N
+    size_t                      m_nSize = 0;
+
+    CircVal<T, Real>* Data() { return m_nSize > N ? m_Heap.data() : m_Inline.data(); }
+
+public:
+    const CircVal<T, Real>* begin() const { return m_nSize > N ? m_Heap.data() : m_Inline.data(); }
+    const CircVal<T, Real>* end  () const { return begin() + m_nSize; }
+    size_t                  size () const { return m_nSize;           }
+    bool                    empty() const { return m_nSize == 0;      }
+
+    void clear()
+    {
+        m_Heap.clear(); // keeps capacity
+        m_nSize = 0;
+    }
+
+    // insert a value (if not already in the set)
+    template<typename... Args>
+    void emplace(Args&&... args)
+    {
+        const CircVal<T, Real> c(std::forward<Args>(args)...);
+
+        CircVal<T, Real>*  pPos = lower_bound(Data(), Data() + m_nSize, c);
+        const size_t nPos = pPos - Data();
+        if (nPos < m_nSize && *pPos == c)
+            return;
+
+        if (m_nSize < N)        // inline
+        {
+            move_backward(pPos, Data() + m_nSize, Data() + m_nSize + 1);
+            *pPos = c;
+        }
+        else
+        {
+            if (m_nSize == N)   // move to heap
+                m_Heap.assign(m_Inline.begin(), m_Inline.end());
+
+            m_Heap.emplace(m_Heap.begin() + nPos, c);
+        }
+
+        ++m_nSize;
+    }
+
+    bool operator==(const set<CircVal<T, Real>>& s) const
+    {
+        return equal(begin(), end(), s.begin(), s.end());
+    }
+};
+
+// ==========================================================================
+// caller-owned scratch buffers for the statistics functions
+// the buffers are resized as needed, and keep their capacity between calls. so when the same scratch
+// is passed to repeated calls (e.g. in a loop), the calls allocate no memory once the buffers are large enough
+struct CircStatScratch
+{
+    vector<double>               Angles ; // converted, sorted values
+    vector<double>               Buffer ; // radix-sort buffer, prefix sums, ...
+    vector<size_t>               Hist   ; // radix-sort histograms
+    vector<double>               Weights; // weights, permuted along with the sorted Angles
+    vector<double>               WBuffer; // radix-sort buffer of Weights
+    vector<double>               Values ; // input values converted to CircVal (e.g. from CircValFixed)
+};
+
+// ==========================================================================
+// summation mode of CircAverage, CircAverage2, WeightedCircAverage
+// Fast       : plain floating-point sums; sums of squares of differences are compared exactly
+// Compensated: compensated sums, and sums of squares of differences evaluated with error-free products.
+//              sums of squares of differences which are at most CircStatTieUlps ULPs apart are considered as equal (ties),
+//              so near-ties are not decided by rounding errors (e.g. for millions of values).
+//              the error-free products use std::fma - affordable only with hardware FMA (-mfma, or -march=native /
+//              CIRCULAR_NATIVE); otherwise each product is a libm software call, several times slower than Fast mode
+enum class CircSumMode { Fast, Compensated };
+
+constexpr size_t CircStatTieUlps = 16;
+
+// sum in the summation mode Mode: plain (Fast) or compensated (Compensated)
+// in Fast mode, f is the plain sum. in Compensated mode, f is the rounded compensated sum c.
+// the mode is a template parameter, so the summation loops have no per-element branch - the statistics functions
+// select the mode once, per call
+template<CircSumMode Mode>
+struct CircStatSum
+{
+    double f = 0.;
+
+    void Add       (double x                    ) { f += x    ; }
+    void AddProduct(double a, double b          ) { f += a*b  ; }
+    void AddProduct(double a, double b, double d) { f += a*b*d; }
+
+    operator double() const { return f; }
+};
+
+template<>
+struct CircStatSum<CircSumMode::Compensated>
+{
+    double         f = 0.;
+    CompensatedSum c;
+
+    void Add       (double x                    ) { c.Add       (x      ); f = c; }
+    void AddProduct(double a, double b          ) { c.AddProduct(a, b   ); f = c; }
+    void AddProduct(double a, double b, double d) { c.AddProduct(a, b, d); f = c; }
+
+    operator double() const { return f; }
+};
+
+// sum of squares of differences from x, for the sectors of CircAverage and WeightedCircAverage (Compensated mode):
+// fW*x^2 - 2*x*Sum + SumSqr + 360^2*fK + s*720*(SumK - x*fK)
+// fW: sum of weights, fK: sum of weights of set C/D, SumK: weighted sum of set C/D; s= -1 for set C, +1 for set D
+// evaluated with error-free products
+inline double SectorSumSqrDiff(double x, double fW, const CompensatedSum& Sum, const CompensatedSum& SumSqr,
+                               double fK, const CompensatedSum& SumK, double s)
+{
+    CompensatedSum D;
+    D.AddProduct(fW, x, x);
+    D.AddProduct(-2.*x, Sum.hi);
+    D.AddProduct(-2.*x, Sum.lo);
+    D.Add       (SumSqr);
+    D.AddProduct(360.*360., fK);
+    D.AddProduct(s*720., SumK.hi);
+    D.AddProduct(s*720., SumK.lo);
+    D.AddProduct(-s*720., x, fK);
+    return D;
+}
+
+// check if a sum of squares of differences is a new minimum (bNew) or equal to the minimum (bTie)
+inline void TestMinSumSqrDiff(double fTestSumDiffSqr, double fMinSumSqrDiff, CircSumMode Mode, bool& bNew, bool& bTie)
+{
+    bTie = Mode == CircSumMode::Compensated ? IsWithinUlps(fTestSumDiffSqr, fMinSumSqrDiff, CircStatTieUlps)
+                                            : fTestSumDiffSqr == fMinSumSqrDiff;
+    bNew = !bTie && fTestSumDiffSqr < fMinSumSqrDiff;
+}
+
+// ==========================================================================
+// calculate average set of circular values, in summation mode Mode
+// MinAvrgVals: set of average values (set<CircVal<T>> or CircValSmallSet<T>)
+// Scratch    : caller-owned buffers
 // T is a circular value type defined with the CircValTypeDef macro
-template<typename T>
-set<CircVal<T>> CircAverage(vector<CircVal<T>> const& A)
+template<CircSumMode Mode, typename T, typename Real, typename ResultSet>
+void CircAverage(span<const CircVal<T, Real>> A, ResultSet& MinAvrgVals, CircStatScratch& Scratch)
 {
     // ----------------------------------------------
     // all vars: UnsignedDegRange [0,360)
-    double          fSum           = 0.; // of all elements of A
-    double          fSumSqr        = 0.; // of all elements of A
-    double          fMinSumSqrDiff     ; // minimal sum of squares of differences
-    vector<double>  LowerAngles        ; // ascending   [  0,180)
-    vector<double>  UpperAngles        ; // descending  (360,180)
-    double          fTestAvrg          ;
-    vector<double>  MinAvrgVals        ; // results set
+    CircStatSum<Mode> Sum                          ; // of all elements of A
+    CircStatSum<Mode> SumSqr                       ; // of all elements of A
+    double          fSum                           ; // of all elements of A
+    double          fSumSqr                        ; // of all elements of A
+    double          fMinSumSqrDiff                 ; // minimal sum of squares of differences
+    vector<double>& LowerAngles    = Scratch.Angles; // ascending   [  0,180)
+    vector<double>& UpperAngles    = Scratch.Buffer; // descending  (360,180)
+    double          fTestAvrg                      ;
+
+    LowerAngles.clear();
+    UpperAngles.clear();
 
     // ----------------------------------------------
     // local functions - implemented as lambdas
@@ -44,8 +205,11 @@ set<CircVal<T>> CircAverage(vector<CircVal<T>> const& A)
     // calc sum(dist(180, Bi)^2) - all values are in set B
     // dist(180,Bi)= |180-Bi|
     // sum(dist(x, Bi)^2) = sum((180-Bi)^2) = sum(180^2-2*180*Bi + Bi^2) = 180^2*A.size - 360*sum(Ai) + sum(Ai^2)
-    auto SumSqr = [&]() -> double
+    auto SumSqrB = [&]() -> double
     {
+        if constexpr (Mode == CircSumMode::Compensated)
+            return SectorSumSqrDiff(180., (double)A.size(), Sum.c, SumSqr.c, 0., {}, 1.);
+
         return 32400.*A.size() - 360.*fSum + fSumSqr;
     };
 
@@ -55,8 +219,12 @@ set<CircVal<T>> CircAverage(vector<CircVal<T>> const& A)
     // sum(dist(x, Bi)^2)= sum(     (x-Bi) ^2)= sum(        Bi^2 + x^2                      - 2*Bi*x)
     // sum(dist(x, Ci)^2)= sum((360-(Ci-x))^2)= sum(360^2 + Ci^2 + x^2 - 2*360*Ci + 2*360*x - 2*Ci*x)
     // sum(dist(x, Bi)^2) + sum(dist(x, Ci)^2) = nCountC*360^2 + sum(Ai^2) + nCountA*x^2 - 2*360*sum(Ci) + nCountC*2*360*x - 2*x*sum(Ai)
-    auto SumSqrC = [&](double x, size_t nCountC, double fSumC) -> double
+    auto SumSqrC = [&](double x, size_t nCountC, const CircStatSum<Mode>& SumC) -> double
     {
+        if constexpr (Mode == CircSumMode::Compensated)
+            return SectorSumSqrDiff(x, (double)A.size(), Sum.c, SumSqr.c, (double)nCountC, SumC.c, -1.);
+
+        const double fSumC = SumC;
         return x*(A.size()*x - 2*fSum) + fSumSqr - 2*360.*fSumC + nCountC*( 2*360.*x + 360.*360.);
     };
 
@@ -66,34 +234,44 @@ set<CircVal<T>> CircAverage(vector<CircVal<T>> const& A)
     // sum(dist(x,Bi)^2)= sum(    (x-Bi)^2)= sum(        Bi^2 + x^2                      - 2*Bi*x)
     // sum(dist(x,Di)^2)= sum(360-(x-Di)^2)= sum(360^2 + Di^2 + x^2 + 2*360*Di - 2*360*x - 2*Di*x)
     // sum(dist(x, Bi)^2) + sum(dist(x, Di)^2) = nCountD*360^2 + sum(Ai^2) + nCountA*x^2 + 2*360*sum(Di) - nCountD*2*360*x - 2*x*sum(Ai)
-    auto SumSqrD = [&](double x, size_t nCountD, double fSumD) -> double
+    auto SumSqrD = [&](double x, size_t nCountD, const CircStatSum<Mode>& SumD) -> double
     {
+        if constexpr (Mode == CircSumMode::Compensated)
+            return SectorSumSqrDiff(x, (double)A.size(), Sum.c, SumSqr.c, (double)nCountD, SumD.c, 1.);
+
+        const double fSumD = SumD;
         return x * (A.size()*x - 2*fSum) + fSumSqr + 2*360.*fSumD + nCountD*(-2*360.*x + 360.*360.);
     };
 
     // update MinAvrgAngles if lower/equal fMinSumSqrDiff found
     auto TestSum = [&](double fTestAvrg, double fTestSumDiffSqr) -> void
     {
-        if (fTestSumDiffSqr < fMinSumSqrDiff)
+        bool bNew, bTie;
+        TestMinSumSqrDiff(fTestSumDiffSqr, fMinSumSqrDiff, Mode, bNew, bTie);
+
+        if (bNew)
         {
             MinAvrgVals.clear();
-            MinAvrgVals.emplace_back(fTestAvrg);
+            MinAvrgVals.emplace(CircVal<UnsignedDegRange>(fTestAvrg)); // convert from [0.360)
             fMinSumSqrDiff = fTestSumDiffSqr;
         }
-        else if (fTestSumDiffSqr == fMinSumSqrDiff)
-            MinAvrgVals.emplace_back(fTestAvrg);
+        else if (bTie)
+            MinAvrgVals.emplace(CircVal<UnsignedDegRange>(fTestAvrg)); // convert from [0.360)
     };
 
     // ----------------------------------------------
     for (const auto& a : A)
     {
         double v = CircVal<UnsignedDegRange>(a); // convert to [0.360)
-        fSum    +=     v ;
-        fSumSqr += Sqr(v);
+        Sum   .Add       (v   );
+        SumSqr.AddProduct(v, v);
              if (v < 180.) LowerAngles.emplace_back(v);
         else if (v > 180.) UpperAngles.emplace_back(v);
     }
 
+    fSum    = Sum   ;
+    fSumSqr = SumSqr;
+
     sort(LowerAngles.begin(), LowerAngles.end()                   ); // ascending   [  0,180)
     sort(UpperAngles.begin(), UpperAngles.end(), greater<double>()); // descending  (360,180)
 
@@ -101,14 +279,14 @@ set<CircVal<T>> CircAverage(vector<CircVal<T>> const& A)
     // start with avrg= 180, sets c,d are empty
     // ----------------------------------------------
     MinAvrgVals.clear();
-    MinAvrgVals.emplace_back(180.);
-    fMinSumSqrDiff = SumSqr();
+    MinAvrgVals.emplace(CircVal<UnsignedDegRange>(180.));
+    fMinSumSqrDiff = SumSqrB();
 
     // ----------------------------------------------
     // average in (180,360), set D: values in range [0,avrg-180)
     // ----------------------------------------------
-    double fLowerBound = 0.; // of current sector
-    double fSumD       = 0.; // of elements of set D
+    double            fLowerBound = 0.; // of current sector
+    CircStatSum<Mode> SumD            ; // of elements of set D
 
     auto iter = LowerAngles.begin();
     for (size_t d = 0; d < LowerAngles.size(); ++d)
@@ -120,10 +298,10 @@ set<CircVal<T>> CircAverage(vector<CircVal<T>> const& A)
         fTestAvrg = (fSum + 360.*d)/A.size(); // average for sector, that minimizes SumDiffSqr
 
         if ((fTestAvrg > fLowerBound+180.) && (fTestAvrg <= *iter+180.))  // if fTestAvrg is within sector
-            TestSum(fTestAvrg, SumSqrD(fTestAvrg, d, fSumD));             // check if fTestAvrg generates lower SumSqr
+            TestSum(fTestAvrg, SumSqrD(fTestAvrg, d, SumD));              // check if fTestAvrg generates lower SumSqr
 
-        fLowerBound  = *iter      ;
-        fSumD       += fLowerBound;
+        fLowerBound  = *iter;
+        SumD.Add(fLowerBound);
         ++iter;
     }
 
@@ -131,13 +309,13 @@ set<CircVal<T>> CircAverage(vector<CircVal<T>> const& A)
     fTestAvrg = (fSum + 360.*LowerAngles.size())/A.size(); // average for sector, that minimizes SumDiffSqr
 
     if ((fTestAvrg < 360.) && (fTestAvrg > fLowerBound))                   // if fTestAvrg is within sector
-        TestSum(fTestAvrg, SumSqrD(fTestAvrg, LowerAngles.size(), fSumD)); // check if fTestAvrg generates lower SumSqr
+        TestSum(fTestAvrg, SumSqrD(fTestAvrg, LowerAngles.size(), SumD));  // check if fTestAvrg generates lower SumSqr
 
     // ----------------------------------------------
     // average in [0,180); set C: values in range (avrg+180, 360)
     // ----------------------------------------------
-    double fUpperBound = 360.; // of current sector
-    double fSumC       =   0.; // of elements of set C
+    double            fUpperBound = 360.; // of current sector
+    CircStatSum<Mode> SumC              ; // of elements of set C
 
     iter = UpperAngles.begin();
     for (size_t c = 0; c < UpperAngles.size(); ++c)
@@ -149,10 +327,10 @@ set<CircVal<T>> CircAverage(vector<CircVal<T>> const& A)
         fTestAvrg = (fSum - 360.*c)/A.size(); // average for sector, that minimizes SumDiffSqr
 
         if ((fTestAvrg >= *iter-180.) && (fTestAvrg < fUpperBound-180.))   // if fTestAvrg is within sector
-            TestSum(fTestAvrg, SumSqrC(fTestAvrg, c, fSumC));              // check if fTestAvrg generates lower SumSqr
+            TestSum(fTestAvrg, SumSqrC(fTestAvrg, c, SumC));               // check if fTestAvrg generates lower SumSqr
 
-        fUpperBound  = *iter      ;
-        fSumC       += fUpperBound;
+        fUpperBound  = *iter;
+        SumC.Add(fUpperBound);
         ++iter;
     }
 
@@ -160,83 +338,697 @@ set<CircVal<T>> CircAverage(vector<CircVal<T>> const& A)
     fTestAvrg = (fSum - 360.*UpperAngles.size())/A.size(); // average for sector, that minimizes SumDiffSqr
 
     if ((fTestAvrg >= 0.) && (fTestAvrg < fUpperBound))                    // if fTestAvrg is within sector
-        TestSum(fTestAvrg, SumSqrC(fTestAvrg, UpperAngles.size(), fSumC)); // check if fTestAvrg generates lower SumSqr
+        TestSum(fTestAvrg, SumSqrC(fTestAvrg, UpperAngles.size(), SumC));  // check if fTestAvrg generates lower SumSqr
+}
 
-    // ----------------------------------------------
-    set<CircVal<T>> MinAvrgCircVals;
-    for (const auto& v : MinAvrgVals)
-        MinAvrgCircVals.emplace(CircVal<UnsignedDegRange>(v)); // convert from [0.360)
+// calculate average set of circular values
+// MinAvrgVals: set of average values (set<CircVal<T>> or CircValSmallSet<T>)
+// Scratch    : caller-owned buffers
+// Mode       : summation mode
+// T is a circular value type defined with the CircValTypeDef macro
+// A may also be a zero-copy view of a CircValArray (CircValArray::View())
+template<typename T, typename Real, typename ResultSet>
+void CircAverage(span<const CircVal<T, Real>> A, ResultSet& MinAvrgVals, CircStatScratch& Scratch, CircSumMode Mode = CircSumMode::Fast)
+{
+    if (Mode == CircSumMode::Compensated) CircAverage<CircSumMode::Compensated>(A, MinAvrgVals, Scratch);
+    else                                  CircAverage<CircSumMode::Fast       >(A, MinAvrgVals, Scratch);
+}
 
-    return MinAvrgCircVals;
+template<typename T, typename Real, typename ResultSet>
+void CircAverage(vector<CircVal<T, Real>> const& A, ResultSet& MinAvrgVals, CircStatScratch& Scratch, CircSumMode Mode = CircSumMode::Fast)
+{
+    CircAverage(span<const CircVal<T, Real>>(A), MinAvrgVals, Scratch, Mode);
 }
 
-// ==========================================================================
 // calculate average set of circular values
 // return set of average values
-// T is a circular value type defined with the CircValTypeDef macro
-template<typename T>
-set<CircVal<T>> CircAverage2(vector<CircVal<T>> const& A)
+template<typename T, typename Real>
+set<CircVal<T, Real>> CircAverage(span<const CircVal<T, Real>> A, CircSumMode Mode = CircSumMode::Fast)
 {
-    const size_t   count         = A.size();
-    double         fSum          = 0.      ; // of all elements of Angles
-    double         fSumSqr       = 0.      ; // of all elements of Angles
-    vector<double> Angles(count)           ; // UnsignedDegRange [0,360), ascendingly sorted
+    set<CircVal<T, Real>> MinAvrgCircVals;
+    CircStatScratch Scratch;
+    CircAverage(A, MinAvrgCircVals, Scratch, Mode);
+    return MinAvrgCircVals;
+}
 
-    for (size_t i = 0; i<count; ++i)
+template<typename T, typename Real>
+set<CircVal<T, Real>> CircAverage(vector<CircVal<T, Real>> const& A, CircSumMode Mode = CircSumMode::Fast)
+{
+    return CircAverage(span<const CircVal<T, Real>>(A), Mode);
+}
+
+// ==========================================================================
+// block size of the sums of CircAverage2, CircAverageLinear, CircAverageAccumulator, CircSlidingWindow
+// the values are summed block by block, and the blocks' sums are then added in order. since the blocks
+// do not depend on the number of threads, the parallel CircAverage2 calculates exactly the same sums as the serial one
+constexpr size_t CircStatBlockSize = 16384;
+
+// sum and sum of squares of a range of values, in blocks of CircStatBlockSize values
+template<typename Range>
+pair<double, double> BlockSums(const Range& V)
+{
+    double fSum      = 0., fSumSqr      = 0.; // of all completed blocks
+    double fBlockSum = 0., fBlockSumSqr = 0.; // of current block
+    size_t i         = 0;
+
+    for (const double v : V)
     {
-        Angles[i]  = CircVal<UnsignedDegRange>(A[i]); // convert to [0,360)
-        fSum      +=     Angles[i] ;
-        fSumSqr   += Sqr(Angles[i]);
+        fBlockSum    +=     v ;
+        fBlockSumSqr += Sqr(v);
+
+        if (++i % CircStatBlockSize == 0)
+        {
+            fSum    += fBlockSum   ; fBlockSum    = 0.;
+            fSumSqr += fBlockSumSqr; fBlockSumSqr = 0.;
+        }
     }
 
-    sort(Angles.begin(), Angles.end()); // ascending
+    return { fSum + fBlockSum, fSumSqr + fBlockSumSqr };
+}
+
+// sum of squares of differences from the average, for shift i (see CircAverageSorted)
+// fShiftSumSqr: sum of squares of the shifted angles, minus 360^2*i
+inline double ShiftSumSqrDiff(double fShiftSumSqr, double fSum, size_t i, size_t count)
+{
+    return fShiftSumSqr + 360.*360.*i - Sqr(fSum+360.*i)/count;
+}
+
+// ==========================================================================
+// calculate average set of circular values, given ascendingly sorted angles
+// Angles : UnsignedDegRange [0,360), ascendingly sorted (any forward range of doubles - e.g. vector, multiset)
+// fSum   : sum of Angles
+// fSumSqr: sum of squares of Angles
+// MinAvrgCircVals: set of average values (set<CircVal<T>> or CircValSmallSet<T>)
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T, typename SortedRange, typename ResultSet>
+void CircAverageSorted(const SortedRange& Angles, double fSum, double fSumSqr, ResultSet& MinAvrgCircVals)
+{
+    const size_t count = size(Angles);
+
+    // avrg from shift index
+    auto ShiftAvrg = [&](size_t i) { return CircVal<UnsignedDegRange>((fSum+360.*i) / count); };
 
     // ----------------------------------------------
     // calc sum of squares of differences for the initial order
     double fMinSumSqrDiff = fSumSqr - Sqr(fSum)/count;
-    vector<size_t> MinShiftIdx = {0}; // indices of shift with minimal avrg
+    MinAvrgCircVals.clear();
+    MinAvrgCircVals.emplace(ShiftAvrg(0));
 
     // calc sum for each order, and test if new minimum found
-    for (size_t i = 1; i<count; ++i)
+    // the increments of fSumSqr are summed in blocks of CircStatBlockSize shifts (as in CircAverageSortedParallel)
+    double fBlockSumSqr = fSumSqr; // fSumSqr at start of current block
+    double fBlockDelta  = 0.     ; // increment of fSumSqr within current block
+
+    auto iter = begin(Angles);
+    for (size_t i = 1; i<count; ++i, ++iter)
     {
-        fSumSqr += 720.*Angles[i-1];
-        const double fTestSumDiffSqr = fSumSqr + 360.*360.*i - Sqr(fSum+360.*i)/count;
+        fBlockDelta += 720.*(*iter); // Angles[i-1]
+        const double fTestSumDiffSqr = ShiftSumSqrDiff(fBlockSumSqr + fBlockDelta, fSum, i, count);
 
         if (fTestSumDiffSqr < fMinSumSqrDiff)       // new minimum found?
         {                                                               
-            MinShiftIdx    = {i};
+            MinAvrgCircVals.clear();
+            MinAvrgCircVals.emplace(ShiftAvrg(i));
             fMinSumSqrDiff = fTestSumDiffSqr;
         }
         else if (fTestSumDiffSqr == fMinSumSqrDiff) // same minimum?
-            MinShiftIdx.emplace_back(i);
+            MinAvrgCircVals.emplace(ShiftAvrg(i));
+
+        if (i % CircStatBlockSize == 0)             // end of block
+        {
+            fBlockSumSqr += fBlockDelta;
+            fBlockDelta   = 0.;
+        }
+    }
+}
+
+// ==========================================================================
+// CircAverageSorted, using nThreads threads
+// the shifts are split into blocks of CircStatBlockSize. the increments of fSumSqr are summed per block concurrently,
+// the blocks' start values are then scanned in order, and finally the blocks' shifts are tested concurrently.
+// returns exactly the same set as CircAverageSorted
+template<typename T, typename ResultSet>
+void CircAverageSortedParallel(span<const double> Angles, double fSum, double fSumSqr, ResultSet& MinAvrgCircVals, unsigned nThreads)
+{
+    const size_t count   = Angles.size();
+    const size_t nBlocks = count > 1 ? (count - 2) / CircStatBlockSize + 1 : 0; // shifts [1,count)
+    const size_t nTasks  = min<size_t>(nThreads, nBlocks);
+
+    // shifts of block k: [k*CircStatBlockSize + 1, min((k+1)*CircStatBlockSize, count-1)]
+    auto BlockEnd = [&](size_t k) { return min((k+1) * CircStatBlockSize + 1, count); };
+
+    // ----------------------------------------------
+    // increment of fSumSqr within each block
+    vector<double> BlockSumSqr(nBlocks + 1); // fSumSqr at start of each block
+    ParallelRun(nTasks, [&](size_t t)
+    {
+        for (size_t k = nBlocks * t / nTasks; k < nBlocks * (t+1) / nTasks; ++k)
+        {
+            double fBlockDelta = 0.;
+            for (size_t i = k * CircStatBlockSize + 1; i < BlockEnd(k); ++i)
+                fBlockDelta += 720.*Angles[i-1];
+
+            BlockSumSqr[k+1] = fBlockDelta;
+        }
+    });
+
+    // scan
+    BlockSumSqr[0] = fSumSqr;
+    for (size_t k = 0; k < nBlocks; ++k)
+        BlockSumSqr[k+1] += BlockSumSqr[k];
+
+    // ----------------------------------------------
+    // minimal shifts of each task
+    struct TaskMin
+    {
+        double         fMinSumSqrDiff = numeric_limits<double>::max();
+        vector<size_t> MinShiftIdx;
+
+        void Test(double fTestSumDiffSqr, size_t i)
+        {
+            if (fTestSumDiffSqr < fMinSumSqrDiff)
+            {
+                MinShiftIdx    = {i};
+                fMinSumSqrDiff = fTestSumDiffSqr;
+            }
+            else if (fTestSumDiffSqr == fMinSumSqrDiff)
+                MinShiftIdx.emplace_back(i);
+        }
+    };
+
+    vector<TaskMin> Mins(max<size_t>(nTasks, 1));
+    Mins[0].Test(fSumSqr - Sqr(fSum)/count, 0); // initial order
+
+    ParallelRun(nTasks, [&](size_t t)
+    {
+        for (size_t k = nBlocks * t / nTasks; k < nBlocks * (t+1) / nTasks; ++k)
+        {
+            double fBlockDelta = 0.;
+            for (size_t i = k * CircStatBlockSize + 1; i < BlockEnd(k); ++i)
+            {
+                fBlockDelta += 720.*Angles[i-1];
+                Mins[t].Test(ShiftSumSqrDiff(BlockSumSqr[k] + fBlockDelta, fSum, i, count), i);
+            }
+        }
+    });
+
+    // ----------------------------------------------
+    double fMinSumSqrDiff = numeric_limits<double>::max();
+    for (const auto& m : Mins)
+        fMinSumSqrDiff = min(fMinSumSqrDiff, m.fMinSumSqrDiff);
+
+    MinAvrgCircVals.clear();
+    for (const auto& m : Mins)
+        if (m.fMinSumSqrDiff == fMinSumSqrDiff)
+            for (const size_t i : m.MinShiftIdx)
+                MinAvrgCircVals.emplace(CircVal<UnsignedDegRange>((fSum+360.*i) / count)); // avrg from shift index
+}
+
+// ==========================================================================
+// CircAverageSorted, in Compensated mode
+// the sums and the prefix sums of Angles are compensated, and count*(sum of squares of differences) of each shift
+// is evaluated with error-free products; shifts within CircStatTieUlps ULPs of the minimum are ties
+template<typename T, typename ResultSet>
+void CircAverageSortedCompensated(span<const double> Angles, ResultSet& MinAvrgCircVals)
+{
+    const size_t count = Angles.size();
+    const double n     = (double)count;
+
+    CompensatedSum Sum, SumSqr; // of all elements of Angles
+    for (const double a : Angles)
+    {
+        Sum   .Add       (a   );
+        SumSqr.AddProduct(a, a);
+    }
+
+    const double fSum = Sum;
+
+    // avrg from shift index
+    auto ShiftAvrg = [&](size_t i) { return CircVal<UnsignedDegRange>((fSum+360.*i) / count); };
+
+    // count*(sum of squares of differences) for shift i: count*(SumSqr + 720*Prefix + 360^2*i) - (Sum + 360*i)^2
+    // Prefix: sum of Angles[0..i)
+    auto ShiftSumSqrDiff = [&](size_t i, const CompensatedSum& Prefix) -> double
+    {
+        CompensatedSum X = Sum; // Sum + 360*i
+        X.Add(360.*i);
+
+        CompensatedSum D;
+        D.AddProduct(n       , SumSqr.hi);
+        D.AddProduct(n       , SumSqr.lo);
+        D.AddProduct(720.*n  , Prefix.hi);
+        D.AddProduct(720.*n  , Prefix.lo);
+        D.AddProduct(129600.*n, (double)i);
+        D.AddProduct(-X.hi   , X.hi     );
+        D.AddProduct(-2.*X.hi, X.lo     );
+        return D;
+    };
+
+    // ----------------------------------------------
+    CompensatedSum Prefix;
+    double fMinSumSqrDiff = ShiftSumSqrDiff(0, Prefix);
+    MinAvrgCircVals.clear();
+    MinAvrgCircVals.emplace(ShiftAvrg(0));
+
+    for (size_t i = 1; i<count; ++i)
+    {
+        Prefix.Add(Angles[i-1]);
+        const double fTestSumDiffSqr = ShiftSumSqrDiff(i, Prefix);
+
+        bool bNew, bTie;
+        TestMinSumSqrDiff(fTestSumDiffSqr, fMinSumSqrDiff, CircSumMode::Compensated, bNew, bTie);
+
+        if (bNew)                                   // new minimum found?
+        {
+            MinAvrgCircVals.clear();
+            MinAvrgCircVals.emplace(ShiftAvrg(i));
+            fMinSumSqrDiff = fTestSumDiffSqr;
+        }
+        else if (bTie)                              // same minimum (up to CircStatTieUlps)?
+            MinAvrgCircVals.emplace(ShiftAvrg(i));
+    }
+}
+
+// ==========================================================================
+// calculate average set of circular values
+// MinAvrgCircVals: set of average values (set<CircVal<T>> or CircValSmallSet<T>)
+// Scratch        : caller-owned buffers
+// Mode           : summation mode
+// T is a circular value type defined with the CircValTypeDef macro
+// A may also be a zero-copy view of a CircValArray (CircValArray::View())
+template<typename T, typename Real, typename ResultSet>
+void CircAverage2(span<const CircVal<T, Real>> A, ResultSet& MinAvrgCircVals, CircStatScratch& Scratch, CircSumMode Mode = CircSumMode::Fast)
+{
+    const size_t    count         = A.size()      ;
+    double          fSum          = 0.            ; // of all elements of Angles
+    double          fSumSqr       = 0.            ; // of all elements of Angles
+    vector<double>& Angles        = Scratch.Angles; // UnsignedDegRange [0,360), ascendingly sorted
+
+    Angles.resize(count);
+
+    for (size_t i = 0; i<count; ++i)
+        Angles[i] = CircVal<UnsignedDegRange>(A[i]); // convert to [0,360)
+
+    if (Mode == CircSumMode::Compensated)
+    {
+        sort(Angles.begin(), Angles.end()); // ascending
+        CircAverageSortedCompensated<T>(Angles, MinAvrgCircVals);
+        return;
+    }
+
+    tie(fSum, fSumSqr) = BlockSums(Angles);
+
+    sort(Angles.begin(), Angles.end()); // ascending
+
+    CircAverageSorted<T>(Angles, fSum, fSumSqr, MinAvrgCircVals);
+}
+
+template<typename T, typename Real, typename ResultSet>
+void CircAverage2(vector<CircVal<T, Real>> const& A, ResultSet& MinAvrgCircVals, CircStatScratch& Scratch, CircSumMode Mode = CircSumMode::Fast)
+{
+    CircAverage2(span<const CircVal<T, Real>>(A), MinAvrgCircVals, Scratch, Mode);
+}
+
+// calculate average set of circular values, using nThreads threads (0: number of hardware threads)
+// the conversion, the sums, the sort and the sweep over the shifts are parallelized
+// returns exactly the same set as the serial CircAverage2
+template<typename T, typename Real, typename ResultSet>
+void CircAverage2(span<const CircVal<T, Real>> A, ResultSet& MinAvrgCircVals, CircStatScratch& Scratch, unsigned nThreads)
+{
+    const size_t    count         = A.size()             ;
+    const unsigned  nTasks        = ThreadCount(nThreads);
+    double          fSum          = 0.                   ; // of all elements of Angles
+    double          fSumSqr       = 0.                   ; // of all elements of Angles
+    vector<double>& Angles        = Scratch.Angles       ; // UnsignedDegRange [0,360), ascendingly sorted
+
+    if (nTasks == 1 || count < 2 * CircStatBlockSize)
+    {
+        CircAverage2(A, MinAvrgCircVals, Scratch);
+        return;
+    }
+
+    Angles.resize(count);
+
+    // convert to [0,360), and sum each block of values
+    const size_t   nBlocks = (count - 1) / CircStatBlockSize + 1;
+    vector<double> BlockSum(nBlocks), BlockSumSqr(nBlocks);
+
+    ParallelRun(nTasks, [&](size_t t)
+    {
+        for (size_t k = nBlocks * t / nTasks; k < nBlocks * (t+1) / nTasks; ++k)
+        {
+            const size_t   i0 = k * CircStatBlockSize, i1 = min(i0 + CircStatBlockSize, count);
+            span<double> Block(Angles.data() + i0, i1 - i0);
+
+            for (size_t i = i0; i < i1; ++i)
+                Angles[i] = CircVal<UnsignedDegRange>(A[i]);
+
+            tie(BlockSum[k], BlockSumSqr[k]) = BlockSums(Block);
+        }
+    });
+
+    for (size_t k = 0; k < nBlocks; ++k) // same order as BlockSums
+    {
+        fSum    += BlockSum   [k];
+        fSumSqr += BlockSumSqr[k];
+    }
+
+    ParallelSort(Angles, Scratch.Buffer, nTasks); // ascending
+
+    CircAverageSortedParallel<T>(Angles, fSum, fSumSqr, MinAvrgCircVals, nTasks);
+}
+
+template<typename T, typename Real, typename ResultSet>
+void CircAverage2(vector<CircVal<T, Real>> const& A, ResultSet& MinAvrgCircVals, CircStatScratch& Scratch, unsigned nThreads)
+{
+    CircAverage2(span<const CircVal<T, Real>>(A), MinAvrgCircVals, Scratch, nThreads);
+}
+
+// calculate average set of circular values
+// return set of average values
+template<typename T, typename Real>
+set<CircVal<T, Real>> CircAverage2(span<const CircVal<T, Real>> A, CircSumMode Mode = CircSumMode::Fast)
+{
+    set<CircVal<T, Real>> MinAvrgCircVals;
+    CircStatScratch Scratch;
+    CircAverage2(A, MinAvrgCircVals, Scratch, Mode);
+    return MinAvrgCircVals;
+}
+
+template<typename T, typename Real>
+set<CircVal<T, Real>> CircAverage2(vector<CircVal<T, Real>> const& A, CircSumMode Mode = CircSumMode::Fast)
+{
+    return CircAverage2(span<const CircVal<T, Real>>(A), Mode);
+}
+
+// calculate average set of circular values, using nThreads threads (0: number of hardware threads)
+// return set of average values
+template<typename T, typename Real>
+set<CircVal<T, Real>> CircAverage2(span<const CircVal<T, Real>> A, unsigned nThreads)
+{
+    set<CircVal<T, Real>> MinAvrgCircVals;
+    CircStatScratch Scratch;
+    CircAverage2(A, MinAvrgCircVals, Scratch, nThreads);
+    return MinAvrgCircVals;
+}
+
+template<typename T, typename Real>
+set<CircVal<T, Real>> CircAverage2(vector<CircVal<T, Real>> const& A, unsigned nThreads)
+{
+    return CircAverage2(span<const CircVal<T, Real>>(A), nThreads);
+}
+
+// ==========================================================================
+// calculate average set of circular values - in linear time
+// same as CircAverage2, but the angles are sorted by an O(n) radix sort (instead of an O(n*log(n)) comparison sort)
+// since the radix sort is exact, the result set is identical to the result set of CircAverage2
+// faster than CircAverage2 for large inputs (see the benchmark in Circular.cpp for the crossover point)
+// MinAvrgCircVals: set of average values (set<CircVal<T>> or CircValSmallSet<T>)
+// Scratch        : caller-owned buffers
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T, typename Real, typename ResultSet>
+void CircAverageLinear(span<const CircVal<T, Real>> A, ResultSet& MinAvrgCircVals, CircStatScratch& Scratch)
+{
+    const size_t    count         = A.size()      ;
+    double          fSum          = 0.            ; // of all elements of Angles
+    double          fSumSqr       = 0.            ; // of all elements of Angles
+    vector<double>& Angles        = Scratch.Angles; // UnsignedDegRange [0,360), ascendingly sorted
+
+    Angles.resize(count);
+
+    for (size_t i = 0; i<count; ++i)
+        Angles[i] = CircVal<UnsignedDegRange>(A[i]); // convert to [0,360)
+
+    tie(fSum, fSumSqr) = BlockSums(Angles);
+
+    RadixSort(Angles, Scratch.Buffer, Scratch.Hist); // ascending
+
+    CircAverageSorted<T>(Angles, fSum, fSumSqr, MinAvrgCircVals);
+}
+
+template<typename T, typename Real, typename ResultSet>
+void CircAverageLinear(vector<CircVal<T, Real>> const& A, ResultSet& MinAvrgCircVals, CircStatScratch& Scratch)
+{
+    CircAverageLinear(span<const CircVal<T, Real>>(A), MinAvrgCircVals, Scratch);
+}
+
+// calculate average set of circular values - in linear time
+// return set of average values
+template<typename T, typename Real>
+set<CircVal<T, Real>> CircAverageLinear(span<const CircVal<T, Real>> A)
+{
+    set<CircVal<T, Real>> MinAvrgCircVals;
+    CircStatScratch Scratch;
+    CircAverageLinear(A, MinAvrgCircVals, Scratch);
+    return MinAvrgCircVals;
+}
+
+template<typename T, typename Real>
+set<CircVal<T, Real>> CircAverageLinear(vector<CircVal<T, Real>> const& A)
+{
+    return CircAverageLinear(span<const CircVal<T, Real>>(A));
+}
+
+// ==========================================================================
+// accumulator of circular values, for calculating the average set of a dynamic collection (e.g. a stream)
+// Add/Remove: O(log(n)). GetAvrg: O(n) - a single sweep over the already-sorted values (no sort)
+// note that the minimal sum of squares may be achieved by O(n) different shifts, so a sweep is required for an exact result
+// GetAvrg returns the same set as CircAverage2 for the accumulated values in ascending order
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+class CircAverageAccumulator
+{
+    multiset<double> m_Angles; // UnsignedDegRange [0,360), ascendingly sorted
+
+public:
+    void Add(const CircVal<T>& c)
+    {
+        m_Angles.emplace((double)CircVal<UnsignedDegRange>(c)); // convert to [0,360)
+    }
+
+    // return false if c was not accumulated
+    bool Remove(const CircVal<T>& c)
+    {
+        auto iter = m_Angles.find((double)CircVal<UnsignedDegRange>(c));
+        if (iter == m_Angles.end())
+            return false;
+
+        m_Angles.erase(iter);
+        return true;
+    }
+
+    void   Clear()       { m_Angles.clear();       }
+    size_t Count() const { return m_Angles.size(); }
+
+    // return set of average values (empty set if no values were accumulated)
+    set<CircVal<T>> GetAvrg() const
+    {
+        set<CircVal<T>> MinAvrgCircVals;
+        GetAvrg(MinAvrgCircVals);
+        return MinAvrgCircVals;
+    }
+
+    // get set of average values (set<CircVal<T>> or CircValSmallSet<T>)
+    template<typename ResultSet>
+    void GetAvrg(ResultSet& MinAvrgCircVals) const
+    {
+        MinAvrgCircVals.clear();
+        if (m_Angles.empty())
+            return;
+
+        const auto [fSum, fSumSqr] = BlockSums(m_Angles); // of all elements (as CircAverage2)
+
+        CircAverageSorted<T>(m_Angles, fSum, fSumSqr, MinAvrgCircVals);
+    }
+};
+
+// ==========================================================================
+// sums of the sines and of the cosines of a block of circular values (sincosN - the SIMD kernel), in a fixed order:
+// the values are processed in chunks of nChunk values (in L1); the sums are split into 4 interleaved partial sums
+// (independent additions - no loop-carried dependency on a single accumulator)
+template<typename T, typename Real>
+pair<double, double> SinCosSums(span<const CircVal<T, Real>> A)
+{
+    constexpr size_t nChunk = 256;
+
+    Real   S[nChunk], C[nChunk];
+    double fSumSin[4] = {}, fSumCos[4] = {};
+
+    for (size_t i0 = 0; i0 < A.size(); i0 += nChunk)
+    {
+        const size_t n = min(nChunk, A.size() - i0);
+        sincosN<T, Real>(A.subspan(i0, n), span<Real>(S, n), span<Real>(C, n));
+
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            for (size_t j = 0; j < 4; ++j)
+            {
+                fSumSin[j] += S[i+j];
+                fSumCos[j] += C[i+j];
+            }
+
+        for (; i < n; ++i)
+        {
+            fSumSin[0] += S[i];
+            fSumCos[0] += C[i];
+        }
+    }
+
+    return { (fSumSin[0] + fSumSin[1]) + (fSumSin[2] + fSumSin[3]),
+             (fSumCos[0] + fSumCos[1]) + (fSumCos[2] + fSumCos[3]) };
+}
+
+// conventional (atan2) circular mean and mean resultant length statistics
+// Count : number of values
+// Mean  : mean direction - atan2 of the mean resultant vector. undefined when RBar is 0 (e.g. no values): Mean is then Z
+// RBar  : mean resultant length in [0,1] - |sum of the unit vectors| / Count
+// Var   : circular variance, 1-RBar
+// StdDev: circular standard deviation, sqrt(-2*ln(RBar)) - in the units of T (radians scaled by T::R/(2*pi)); infinite when RBar is 0
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T, typename Real = double>
+struct CircMeanResultantStats
+{
+    size_t           Count ;
+    CircVal<T, Real> Mean  ;
+    double           RBar  ;
+    double           Var   ;
+    double           StdDev;
+};
+
+// partial state of the conventional circular mean: the number of values, and the sums of their sines and cosines.
+// the statistics of a union of disjoint parts are calculated from the merged states of the parts (map-reduce) - Merge is
+// commutative and associative, up to the rounding of the sums
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+class CircMeanResultantState
+{
+    size_t m_Count   = 0 ;
+    double m_fSumSin = 0.;
+    double m_fSumCos = 0.;
+
+public:
+    template<typename Real>
+    void Add(const CircVal<T, Real>& c)
+    {
+        Real s, co;
+        sincos(c, s, co);
+        ++m_Count;
+        m_fSumSin += s;
+        m_fSumCos += co;
+    }
+
+    // add a span of values, in blocks of CircStatBlockSize values (the same sums as CircMeanResultant)
+    template<typename Real>
+    void Add(span<const CircVal<T, Real>> A)
+    {
+        for (size_t i0 = 0; i0 < A.size(); i0 += CircStatBlockSize)
+        {
+            const auto [fSumSin, fSumCos] = SinCosSums(A.subspan(i0, min(CircStatBlockSize, A.size() - i0)));
+            m_fSumSin += fSumSin;
+            m_fSumCos += fSumCos;
+        }
+
+        m_Count += A.size();
+    }
+
+    template<typename Real>
+    void Add(vector<CircVal<T, Real>> const& A)
+    {
+        Add(span<const CircVal<T, Real>>(A));
+    }
+
+    // add the values of another state
+    void Merge(const CircMeanResultantState& Other)
+    {
+        m_Count   += Other.m_Count  ;
+        m_fSumSin += Other.m_fSumSin;
+        m_fSumCos += Other.m_fSumCos;
+    }
+
+    void   Clear ()       { *this = CircMeanResultantState(); }
+    size_t Count () const { return m_Count;                   }
+    double SumSin() const { return m_fSumSin;                 }
+    double SumCos() const { return m_fSumCos;                 }
+
+    template<typename Real = double>
+    CircMeanResultantStats<T, Real> Get() const
+    {
+        const double fR = m_Count ? min(1., hypot(m_fSumSin, m_fSumCos) / double(m_Count)) : 0.; // rounding may exceed 1
+
+        return { m_Count,
+                 atan2<T, Real>(Real(m_fSumSin), Real(m_fSumCos)),
+                 fR,
+                 1. - fR,
+                 fR < 1. ? sqrt(-2. * log(fR)) * (T::R / (2. * numbers::pi)) : 0. };
+    }
+};
+
+// calculate the conventional (atan2) circular mean and the mean resultant length statistics - in a single pass, without sort:
+// the sines and cosines are calculated by the fused sincosN kernel, and summed per block of CircStatBlockSize values.
+// nThreads: number of threads (0: number of hardware threads). the blocks are summed concurrently, and their sums are
+// added in block order - so the result does not depend on the number of threads
+// an O(n) alternative to CircAverage - but a different estimator: the direction of the mean resultant vector (not the
+// minimizer of the sum of squared arc distances)
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T, typename Real>
+CircMeanResultantStats<T, Real> CircMeanResultant(span<const CircVal<T, Real>> A, unsigned nThreads = 1)
+{
+    const size_t   count  = A.size();
+    const unsigned nTasks = ThreadCount(nThreads);
+
+    CircMeanResultantState<T> State;
+
+    if (nTasks == 1 || count < 2 * CircStatBlockSize)
+    {
+        State.Add(A);
+        return State.template Get<Real>();
     }
 
-    // ----------------------------------------------
-    set<CircVal<T>> MinAvrgCircVals;
-    for (const auto& i : MinShiftIdx)
-        MinAvrgCircVals.emplace(CircVal<UnsignedDegRange>((fSum+360.*i) / count)); // avrg from shift index
+    const size_t                      nBlocks = (count - 1) / CircStatBlockSize + 1;
+    vector<CircMeanResultantState<T>> BlockState(nBlocks);
 
-    return MinAvrgCircVals;
+    ParallelRun(nTasks, [&](size_t t)
+    {
+        for (size_t k = nBlocks * t / nTasks; k < nBlocks * (t+1) / nTasks; ++k)
+            BlockState[k].Add(A.subspan(k * CircStatBlockSize, min(CircStatBlockSize, count - k * CircStatBlockSize)));
+    });
+
+    for (const auto& B : BlockState) // block order - as CircMeanResultantState::Add
+        State.Merge(B);
+
+    return State.template Get<Real>();
 }
 
-// ==========================================================================
-// calculate weighted-average set of circular values
-// return set of average values
-// T is a circular value type defined with the CircValTypeDef macro
-template<typename T>
-set<CircVal<T>> WeightedCircAverage(vector<pair<CircVal<T>,double>> const& A) // vector <value,weight>
+template<typename T, typename Real>
+CircMeanResultantStats<T, Real> CircMeanResultant(vector<CircVal<T, Real>> const& A, unsigned nThreads = 1)
 {
-    set<CircVal<T>>              MinAvrgVals        ; // results set
+    return CircMeanResultant(span<const CircVal<T, Real>>(A), nThreads);
+}
 
+// ==========================================================================
+// calculate weighted-average set of circular values - of columnar <angle,weight> data in Scratch.Angles, Scratch.Weights
+// (UnsignedDegRange [0,360) angles, input order). used by the WeightedCircAverage overloads
+// the angles are radix-sorted along with their weights: [0,180) ascending, then 180 (skipped), then (180,360) - swept
+// in descending order
+// MinAvrgVals: set of average values (set<CircVal<T>> or CircValSmallSet<T>)
+// Mode       : summation mode
+template<CircSumMode Mode, typename ResultSet>
+void WeightedCircAverageColumns(ResultSet& MinAvrgVals, CircStatScratch& Scratch)
+{
     // ----------------------------------------------
     // all vars: UnsignedDegRange [0,360)
-    double                       fASumW         = 0.; // sum(Wi     ) of all elements of A
-    double                       fASumWA        = 0.; // sum(Wi*Ai  ) of all elements of A
-    double                       fASumWA2       = 0.; // sum(Wi*Ai^2) of all elements of A
-    double                       fMinSumSqrDiff     ; // minimal sum of squares of differences
-    vector<pair<double, double>> LowerAngles        ; // ascending   [  0,180)  <angle,weight>
-    vector<pair<double, double>> UpperAngles        ; // descending  (360,180)  <angle,weight>
-    double                       fTestAvrg          ;
+    CircStatSum<Mode> ASumW                         ; // sum(Wi     ) of all elements of A
+    CircStatSum<Mode> ASumWA                        ; // sum(Wi*Ai  ) of all elements of A
+    CircStatSum<Mode> ASumWA2                       ; // sum(Wi*Ai^2) of all elements of A
+    double          fASumW                          ; // sum(Wi     ) of all elements of A
+    double          fASumWA                         ; // sum(Wi*Ai  ) of all elements of A
+    double          fASumWA2                        ; // sum(Wi*Ai^2) of all elements of A
+    double          fMinSumSqrDiff                  ; // minimal sum of squares of differences
+    vector<double>& Angles         = Scratch.Angles ; // ascending [0,360). LowerAngles: [0,nLower); UpperAngles: [nUpper,n) - swept in descending order
+    vector<double>& Weights        = Scratch.Weights; // weights of Angles
+    double          fTestAvrg                       ;
+
+    assert(Angles.size() == Weights.size());
 
     // ----------------------------------------------
     // local functions - implemented as lambdas
@@ -247,6 +1039,9 @@ set<CircVal<T>> WeightedCircAverage(vector<pair<CircVal<T>,double>> const& A) //
     // sum(Wi*dist(x, Bi)^2) = sum(Wi*(180-Bi)^2) = sum(Wi*(180^2-2*180*Bi + Bi^2)) = 180^2*fSumW - 360*sum(Wi*Ai) + sum(Wi*Ai^2)
     auto SumSqr = [&]() -> double
     {
+        if constexpr (Mode == CircSumMode::Compensated)
+            return SectorSumSqrDiff(180., fASumW, ASumWA.c, ASumWA2.c, 0., {}, 1.);
+
         return 32400.*fASumW - 360.*fASumWA + fASumWA2;
     };
 
@@ -257,10 +1052,14 @@ set<CircVal<T>> WeightedCircAverage(vector<pair<CircVal<T>,double>> const& A) //
     // sum(Wi*dist(x,Ci)^2)= sum(Wi*((360-(Ci-x))^2))= sum(Wi*(360^2 + Ci^2 + x^2 - 2*360*Ci + 2*360*x - 2*Ci*x))
     //                                                 ==========================================================
     //                                                 sum(Wi*(        Ai^2 + x^2                      - 2*Ai*x))
-    auto SumSqrC = [&](double x      ,
-                       double fCSumW ,            // sum(Wi   ) of all elements of C
-                       double fCSumWC ) -> double // sum(Wi*Ci) of all elements of C
+    auto SumSqrC = [&](double                   x      ,
+                       const CircStatSum<Mode>& CSumW ,            // sum(Wi   ) of all elements of C
+                       const CircStatSum<Mode>& CSumWC ) -> double // sum(Wi*Ci) of all elements of C
     {
+        if constexpr (Mode == CircSumMode::Compensated)
+            return SectorSumSqrDiff(x, fASumW, ASumWA.c, ASumWA2.c, CSumW, CSumWC.c, -1.);
+
+        const double fCSumW = CSumW, fCSumWC = CSumWC;
         return fASumWA2 + x*x*fASumW -2*x*fASumWA - 720*fCSumWC + (129600+720*x)*fCSumW;
     };
 
@@ -271,41 +1070,52 @@ set<CircVal<T>> WeightedCircAverage(vector<pair<CircVal<T>,double>> const& A) //
     // sum(Wi*dist(x,Di)^2)= sum(Wi*((360-(x-Di))^2))= sum(Wi*(360^2 + Di^2 + x^2 + 2*360*Di - 2*360*x - 2*Di*x))
     //                                                 ==========================================================
     //                                                 sum(Wi*(        Ai^2 + x^2                      - 2*Ai*x))
-    auto SumSqrD = [&](double x      ,
-                       double fDSumW ,            // sum(Wi   ) of all elements of D
-                       double fDSumWD ) -> double // sum(Wi*Di) of all elements of D
+    auto SumSqrD = [&](double                   x      ,
+                       const CircStatSum<Mode>& DSumW ,            // sum(Wi   ) of all elements of D
+                       const CircStatSum<Mode>& DSumWD ) -> double // sum(Wi*Di) of all elements of D
     {
+        if constexpr (Mode == CircSumMode::Compensated)
+            return SectorSumSqrDiff(x, fASumW, ASumWA.c, ASumWA2.c, DSumW, DSumWD.c, 1.);
+
+        const double fDSumW = DSumW, fDSumWD = DSumWD;
         return fASumWA2 + x*x*fASumW -2*x*fASumWA + 720*fDSumWD + (129600-720*x)*fDSumW;
     };
 
     // update MinAvrgAngles if lower/equal fMinSumSqrDiff found
     auto TestSum = [&](double fTestAvrg, double fTestSumDiffSqr) -> void
     {
-        if (fTestSumDiffSqr < fMinSumSqrDiff)
+        bool bNew, bTie;
+        TestMinSumSqrDiff(fTestSumDiffSqr, fMinSumSqrDiff, Mode, bNew, bTie);
+
+        if (bNew)
         {
             MinAvrgVals.clear();
             MinAvrgVals.emplace(CircVal<UnsignedDegRange>(fTestAvrg));
             fMinSumSqrDiff= fTestSumDiffSqr;
         }
-        else if (fTestSumDiffSqr == fMinSumSqrDiff)
+        else if (bTie)
             MinAvrgVals.emplace(CircVal<UnsignedDegRange>(fTestAvrg));
     };
 
     // ----------------------------------------------
-    for (const auto& a : A)
+    const size_t n = Angles.size();
+    for (size_t i = 0; i < n; ++i)
     {
-        double v  = CircVal<UnsignedDegRange>(a.first); // convert to [0.360)
-        double w  = a.second;                           // weight
-        fASumW   += w    ;
-        fASumWA  += w*v  ;
-        fASumWA2  = w*v*v;
-
-             if (v < 180.) LowerAngles.emplace_back(pair<double,double>(v,w));
-        else if (v > 180.) UpperAngles.emplace_back(pair<double,double>(v,w));
+        const double v = Angles [i]; // [0.360)
+        const double w = Weights[i]; // weight
+        ASumW  .Add       (w      );
+        ASumWA .AddProduct(w, v   );
+        ASumWA2.AddProduct(w, v, v);
     }
 
-    sort(LowerAngles.begin(), LowerAngles.end()                                ); // ascending   [  0,180)
-    sort(UpperAngles.begin(), UpperAngles.end(), greater<pair<double,double>>()); // descending  (360,180)
+    fASumW   = ASumW  ;
+    fASumWA  = ASumWA ;
+    fASumWA2 = ASumWA2;
+
+    RadixSort(Angles, Weights, Scratch.Buffer, Scratch.WBuffer, Scratch.Hist); // ascending
+
+    const size_t nLower = size_t(lower_bound(Angles.begin(), Angles.end(), 180.) - Angles.begin()); // [  0,180)
+    const size_t nUpper = size_t(upper_bound(Angles.begin(), Angles.end(), 180.) - Angles.begin()); // (180,360)
 
     // ----------------------------------------------
     // start with avrg= 180, sets c,d are empty
@@ -317,69 +1127,144 @@ set<CircVal<T>> WeightedCircAverage(vector<pair<CircVal<T>,double>> const& A) //
     // ----------------------------------------------
     // average in (180,360), set D: values in range [0,avrg-180)
     // ----------------------------------------------
-    double fLowerBound = 0.; // of current sector
-    double fDSumW      = 0.; // sum(Wi   ) of all elements of D
-    double fDSumWD     = 0.; // sum(Wi*Di) of all elements of D
+    double            fLowerBound = 0.; // of current sector
+    CircStatSum<Mode> DSumW           ; // sum(Wi   ) of all elements of D
+    CircStatSum<Mode> DSumWD          ; // sum(Wi*Di) of all elements of D
 
-    auto iter = LowerAngles.begin();
-    for (size_t d = 0; d < LowerAngles.size(); ++d)
+    for (size_t d = 0; d < nLower; ++d)
     {
         // 1st  iteration : average in (                 180, lowerAngles[0]+180]
         // next iterations: average in (lowerAngles[i-1]+180, lowerAngles[i]+180]
         // set D          : lowerAngles[0..d]
 
-        fTestAvrg = (fASumWA + 360.*fDSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
+        fTestAvrg = (fASumWA + 360.*DSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
 
-        if ((fTestAvrg > fLowerBound+180.) && (fTestAvrg <= (*iter).first+180.)) // if fTestAvrg is within sector
-            TestSum(fTestAvrg, SumSqrD(fTestAvrg, fDSumW, fDSumWD));             // check if fTestAvrg generates lower SumSqr
+        if ((fTestAvrg > fLowerBound+180.) && (fTestAvrg <= Angles[d]+180.))     // if fTestAvrg is within sector
+            TestSum(fTestAvrg, SumSqrD(fTestAvrg, DSumW, DSumWD));               // check if fTestAvrg generates lower SumSqr
 
-        fLowerBound  = (*iter).first                 ;
-        fDSumW      += (*iter).second                ;
-        fDSumWD     += (*iter).second * (*iter).first;
-        ++iter;
+        fLowerBound = Angles[d];
+        DSumW .Add       (Weights[d]           );
+        DSumWD.AddProduct(Weights[d], Angles[d]);
     }
 
     // last sector : average in [lowerAngles[lastIdx]+180, 360)
-    fTestAvrg = (fASumWA + 360.*fDSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
+    fTestAvrg = (fASumWA + 360.*DSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
 
     if ((fTestAvrg < 360.) && (fTestAvrg > fLowerBound))                         // if fTestAvrg is within sector
-        TestSum(fTestAvrg, SumSqrD(fTestAvrg, fDSumW, fDSumWD));                 // check if fTestAvrg generates lower SumSqr
+        TestSum(fTestAvrg, SumSqrD(fTestAvrg, DSumW, DSumWD));                   // check if fTestAvrg generates lower SumSqr
 
     // ----------------------------------------------
     // average in [0,180); set C: values in range (avrg+180, 360)
     // ----------------------------------------------
-    double fUpperBound = 360.; // of current sector
-    double fCSumW      =   0.; // sum(Wi   ) of all elements of C
-    double fCSumWC     =   0.; // sum(Wi*Ci) of all elements of C
+    double            fUpperBound = 360.; // of current sector
+    CircStatSum<Mode> CSumW             ; // sum(Wi   ) of all elements of C
+    CircStatSum<Mode> CSumWC            ; // sum(Wi*Ci) of all elements of C
 
-    iter = UpperAngles.begin();
-    for (size_t c = 0; c < UpperAngles.size(); ++c)
+    for (size_t c = n; c-- > nUpper; )
     {
         // 1st  iteration : average in [upperAngles[0]-180, 360                 )
         // next iterations: average in [upperAngles[i]-180, upperAngles[i-1]-180)
         // set C          : upperAngles[0..c]  (descendingly sorted)
 
-        fTestAvrg = (fASumWA - 360.*fCSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
+        fTestAvrg = (fASumWA - 360.*CSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
 
-        if ((fTestAvrg >= (*iter).first-180.) && (fTestAvrg < fUpperBound-180.)) // if fTestAvrg is within sector
-            TestSum(fTestAvrg, SumSqrC(fTestAvrg, fCSumW, fCSumWC));             // check if fTestAvrg generates lower SumSqr
+        if ((fTestAvrg >= Angles[c]-180.) && (fTestAvrg < fUpperBound-180.))     // if fTestAvrg is within sector
+            TestSum(fTestAvrg, SumSqrC(fTestAvrg, CSumW, CSumWC));               // check if fTestAvrg generates lower SumSqr
 
-        fUpperBound  = (*iter).first                 ;
-        fCSumW      += (*iter).second                ;
-        fCSumWC     += (*iter).second * (*iter).first;
-        ++iter;
+        fUpperBound = Angles[c];
+        CSumW .Add       (Weights[c]           );
+        CSumWC.AddProduct(Weights[c], Angles[c]);
     }
 
     // last sector : average in [0, upperAngles[lastIdx]-180)
-    fTestAvrg = (fASumWA - 360.*fCSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
+    fTestAvrg = (fASumWA - 360.*CSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
 
     if ((fTestAvrg >= 0.) && (fTestAvrg < fUpperBound))                          // if fTestAvrg is within sector
-        TestSum(fTestAvrg, SumSqrC(fTestAvrg, fCSumW, fCSumWC));                 // check if fTestAvrg generates lower SumSqr
+        TestSum(fTestAvrg, SumSqrC(fTestAvrg, CSumW, CSumWC));                   // check if fTestAvrg generates lower SumSqr
+}
 
-    // ----------------------------------------------
+template<typename ResultSet>
+void WeightedCircAverageColumns(ResultSet& MinAvrgVals, CircStatScratch& Scratch, CircSumMode Mode)
+{
+    if (Mode == CircSumMode::Compensated) WeightedCircAverageColumns<CircSumMode::Compensated>(MinAvrgVals, Scratch);
+    else                                  WeightedCircAverageColumns<CircSumMode::Fast       >(MinAvrgVals, Scratch);
+}
+
+// ==========================================================================
+// calculate weighted-average set of circular values
+// MinAvrgVals: set of average values (set<CircVal<T>> or CircValSmallSet<T>)
+// Scratch    : caller-owned buffers
+// Mode       : summation mode
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T, typename Real, typename ResultSet>
+void WeightedCircAverage(vector<pair<CircVal<T, Real>,double>> const& A, ResultSet& MinAvrgVals, CircStatScratch& Scratch, // vector <value,weight>
+                         CircSumMode Mode = CircSumMode::Fast)
+{
+    Scratch.Angles .resize(A.size());
+    Scratch.Weights.resize(A.size());
+    for (size_t i = 0; i < A.size(); ++i)
+    {
+        Scratch.Angles [i] = CircVal<UnsignedDegRange>(A[i].first); // convert to [0.360)
+        Scratch.Weights[i] = A[i].second;
+    }
+
+    WeightedCircAverageColumns(MinAvrgVals, Scratch, Mode);
+}
+
+// calculate weighted-average set of columnar circular values: values and weights in separate arrays (of equal sizes)
+// no <value,weight> pairs are built; no allocation if the capacities of Scratch suffice. the result is the same as of
+// the <value,weight> overload
+template<typename T, typename Real, typename ResultSet>
+void WeightedCircAverage(span<const CircVal<T, Real>> Values, span<const double> Weights, ResultSet& MinAvrgVals,
+                         CircStatScratch& Scratch, CircSumMode Mode = CircSumMode::Fast)
+{
+    assert(Values.size() == Weights.size());
+
+    Scratch.Angles .resize(Values.size());
+    Scratch.Weights.assign(Weights.begin(), Weights.end());
+    for (size_t i = 0; i < Values.size(); ++i)
+        Scratch.Angles[i] = CircVal<UnsignedDegRange>(Values[i]); // convert to [0.360)
+
+    WeightedCircAverageColumns(MinAvrgVals, Scratch, Mode);
+}
+
+template<typename T, typename Real, typename ResultSet>
+void WeightedCircAverage(vector<CircVal<T, Real>> const& Values, vector<double> const& Weights, ResultSet& MinAvrgVals,
+                         CircStatScratch& Scratch, CircSumMode Mode = CircSumMode::Fast)
+{
+    WeightedCircAverage(span<const CircVal<T, Real>>(Values), span<const double>(Weights), MinAvrgVals, Scratch, Mode);
+}
+
+// calculate weighted-average set of circular values
+// return set of average values
+template<typename T, typename Real>
+set<CircVal<T, Real>> WeightedCircAverage(vector<pair<CircVal<T, Real>,double>> const& A, CircSumMode Mode = CircSumMode::Fast) // vector <value,weight>
+{
+    set<CircVal<T, Real>> MinAvrgVals;
+    CircStatScratch Scratch;
+    WeightedCircAverage(A, MinAvrgVals, Scratch, Mode);
+    return MinAvrgVals;
+}
+
+// calculate weighted-average set of columnar circular values
+// return set of average values
+template<typename T, typename Real>
+set<CircVal<T, Real>> WeightedCircAverage(span<const CircVal<T, Real>> Values, span<const double> Weights,
+                                          CircSumMode Mode = CircSumMode::Fast)
+{
+    set<CircVal<T, Real>> MinAvrgVals;
+    CircStatScratch Scratch;
+    WeightedCircAverage(Values, Weights, MinAvrgVals, Scratch, Mode);
     return MinAvrgVals;
 }
 
+template<typename T, typename Real>
+set<CircVal<T, Real>> WeightedCircAverage(vector<CircVal<T, Real>> const& Values, vector<double> const& Weights,
+                                          CircSumMode Mode = CircSumMode::Fast)
+{
+    return WeightedCircAverage(span<const CircVal<T, Real>>(Values), span<const double>(Weights), Mode);
+}
+
 // ==========================================================================
 // estimate the average of a sampled continuous-time circular signal, using circular linear interpolation
 // T is a circular value type defined with the CircValTypeDef macro
@@ -389,7 +1274,8 @@ class CAvrgSampledCircSignal
     size_t                           m_nSamples ;
     CircVal<T>                       m_PrevC    ; // previous value
     double                           m_fPrevTime; // previous time
-    vector<pair<CircVal<T>, double>> m_Intervals; // vector of (avrg,weight) for each interval
+    vector<CircVal<T>>               m_Avrgs    ; // average of each interval
+    vector<double>                   m_Weights  ; // weight  of each interval
 
 public:
     CAvrgSampledCircSignal()
@@ -405,7 +1291,8 @@ public:
 
             double fIntervalAvrg   = CircVal<T>::Wrap((double)m_PrevC + CircVal<T>::Sdist(m_PrevC, C) / 2.);
             double fIntervalWeight = fTime - m_fPrevTime                                                   ;
-            m_Intervals.emplace_back(fIntervalAvrg, fIntervalWeight);
+            m_Avrgs  .emplace_back(fIntervalAvrg  );
+            m_Weights.emplace_back(fIntervalWeight);
         }
 
         m_PrevC     = C    ;
@@ -427,36 +1314,37 @@ public:
             return true;
 
         default:
-            Avrg = *WeightedCircAverage(m_Intervals).begin();
+            Avrg = *WeightedCircAverage(m_Avrgs, m_Weights).begin();
             return true;
         }
     }
 };
 
 // ==========================================================================
-// calculate median set of circular values
+// calculate median set of circular values - reference implementation, O(n^2)
+// the sum of distances of each candidate is calculated directly. used by CircStatTester to verify CircMedian
 // return set of median values
 // T is a circular value type defined with the CircValTypeDef macro
-template<typename T>
-set<CircVal<T>> CircMedian(vector<CircVal<T>> const& A)
+template<typename T, typename Real>
+set<CircVal<T, Real>> CircMedianBruteForce(span<const CircVal<T, Real>> A)
 {
-    set <CircVal<T>> X;           // results set
+    set <CircVal<T, Real>> X;           // results set
 
     // ----------------------------------------------
-    set<CircVal<T>> B;
+    set<CircVal<T, Real>> B;
     if (A.size() % 2 == 0)        // even number of values
     {
-        auto S = A;
+        vector<CircVal<T, Real>> S(A.begin(), A.end());
         sort(S.begin(), S.end()); // A, sorted
 
         for (size_t m = 0; m < S.size(); ++m)
         {
             size_t n = m+1; if (n == S.size()) n = 0;
-            double d = CircVal<T>::Sdist(S[m], S[n]);
+            double d = CircVal<T, Real>::Sdist(S[m], S[n]);
 
             // insert average set of each two circular-consecutive values
             B.emplace((double)S[m] + d / 2.);
-            if (d == -CircVal<T>::GetR() / 2.)
+            if (d == -CircVal<T, Real>::GetR() / 2.)
                 B.emplace((double)S[n] + d / 2.);
         }
     }
@@ -471,7 +1359,7 @@ set<CircVal<T>> CircMedian(vector<CircVal<T>> const& A)
     {
         double fSum = 0.;         // sum(|Sdist(a, b)|)
         for (const auto& a : A)
-            fSum += abs(CircVal<T>::Sdist(b, a));
+            fSum += abs(CircVal<T, Real>::Sdist(b, a));
 
              if (fSum == fMinSum)              X.emplace(b);
         else if (fSum <  fMinSum) { X.clear(); X.emplace(b); fMinSum = fSum; }
@@ -480,3 +1368,868 @@ set<CircVal<T>> CircMedian(vector<CircVal<T>> const& A)
     // ----------------------------------------------
     return X;
 }
+
+template<typename T, typename Real>
+set<CircVal<T, Real>> CircMedianBruteForce(vector<CircVal<T, Real>> const& A)
+{
+    return CircMedianBruteForce(span<const CircVal<T, Real>>(A));
+}
+
+// ==========================================================================
+// calculate median set of circular values, given ascendingly sorted values
+// S      : values of A [T::L, T::H), ascendingly sorted
+// X      : set of median values (set<CircVal<T>> or CircValSmallSet<T>)
+// Scratch: buffer for prefix sums (resized to 2*(S.size()+1); no allocation if its capacity suffices)
+// SumDistExact: SumDistExact(b) returns sum(|Sdist(b, a)|) summed directly, in the order of CircMedianBruteForce's input
+//               (of CircVal<T, Real> values)
+// the candidates are the same as CircMedianBruteForce's. the sum of distances of each candidate is calculated in O(log(n))
+// from compensated prefix sums, so the filtering is O(n*log(n)) instead of O(n^2). the prefix sums are rounded differently
+// than the direct sums, so they only filter: a candidate is dropped if the lower bound of its direct sum exceeds the
+// minimal upper bound. the bounds are relative to each candidate's sum, so tightly clustered values are filtered as well
+// as spread ones. the sums of the remaining candidates (usually 1 or 2; more for ties) are calculated by SumDistExact,
+// and compared exactly - so the median set is CircMedianBruteForce's
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T, typename Real = double, typename ResultSet, typename F>
+void CircMedianSorted(span<const double> S, ResultSet& X, vector<double>& Scratch, F SumDistExact)
+{
+    X.clear();
+
+    const size_t n = S.size();
+    if (n == 0)
+        return;
+
+    // ----------------------------------------------
+    // compensated prefix sums of the values: Hi[i]+Lo[i] = sum(S[0..i))
+    // u: unit roundoff of double; uR: of Real (the type of SumDistExact's distances)
+    // M: bound of |value|, |candidate| and R
+    constexpr double u  = numeric_limits<double>::epsilon() / 2.;
+    constexpr double uR = numeric_limits<Real  >::epsilon() / 2.;
+    constexpr double M  = (-T::L > T::H ? -T::L : T::H) + T::R;
+
+    Scratch.resize(2*(n+1));
+    double* const Hi = Scratch.data();
+    double* const Lo = Scratch.data() + (n+1);
+
+    CompensatedSum Prefix;
+    Hi[0] = Lo[0] = 0.;
+    for (size_t i = 0; i < n; ++i)
+    {
+        Prefix.Add(S[i]);
+        Hi[i+1] = Prefix.hi;
+        Lo[i+1] = Prefix.lo;
+    }
+
+    // rounding error bound of a compensated prefix sum (of the accumulation of the n compensation terms)
+    const double fErrP = 2. * u*u * n*n * (n * M);
+
+    auto Index = [&](double x) -> size_t { return lower_bound(S.begin(), S.end(), x) - S.begin(); };
+
+    // sum(|Sdist(b, a)|) for all values a, and its rounding error bound
+    // the values are split at b and at the antipode y of b into 3 ranges of consecutive indices:
+    //   b+R/2 <= H:  [L, b): b-a     [b, y): a-b     [y, H): b-a+R (wrapped)
+    //   b+R/2 >  H:  [L, y): a-b+R   [y, b): b-a     [b, H): a-b
+    // nW: number of wrapped distances
+    // values within the rounding error of y may be classified to the wrong side of it - their distances are ~R/2 either way
+    struct SumDistT { double fSum, fErr; size_t nW; };
+    auto SumDist = [&](double b) -> SumDistT
+    {
+        CompensatedSum D;
+        ptrdiff_t nCount = 0; // number of values a>=b - number of values a<b
+
+        // add sign*(sum of the values of [i,j))
+        auto AddRange = [&](size_t i, size_t j, double sign)
+        {
+            D.Add( sign * Hi[j]);
+            D.Add(-sign * Hi[i]);
+            D.Add( sign * (Lo[j] - Lo[i]));
+            nCount += (sign > 0. ? 1 : -1) * ptrdiff_t(j - i);
+        };
+
+        const size_t ib = Index(b);
+        size_t nW;
+        double y;
+        if (b + T::R_2 <= T::H)
+        {
+            y = b + T::R_2;
+            const size_t iy = Index(y);
+            AddRange(0 , ib, -1.);
+            AddRange(ib, iy, +1.);
+            AddRange(iy, n , -1.);
+            nW = n - iy;
+        }
+        else
+        {
+            y = b - T::R_2;
+            const size_t iy = Index(y);
+            AddRange(0 , iy, +1.);
+            AddRange(iy, ib, -1.);
+            AddRange(ib, n , +1.);
+            nW = iy;
+        }
+
+        D.AddProduct(-b  , double(nCount));
+        D.AddProduct(T::R, double(nW    ));
+
+        // values near y: each classified wrongly contributes an error of up to 2*|a-y| + 2*|rounding of y|
+        const double fDelta = 4. * u * M;
+        const size_t nB     = Index(y + fDelta) - Index(y - fDelta);
+
+        // Neumaier summation of ~12 terms up to n*M, 6 prefix sums, and the values near y
+        const double fSum = D;
+        const double fErr = 2. * u * abs(fSum) + 4096. * u*u * n * M + 6. * fErrP + 4. * fDelta * nB;
+        return { fSum, fErr, nW + nB };
+    };
+
+    // rounding error bound of SumDistExact(b), given an upper bound of its sum:
+    // n additions, a rounding of each distance (and of R for wrapped distances), and the rounding of b to Real
+    auto ErrExact = [&](double fUpper, size_t nW) -> double
+    {
+        double fErr = 2. * ((n + 2.) * u + 2. * uR) * fUpper + 4. * uR * T::R * nW;
+        if constexpr (!is_same_v<Real, double>)
+            fErr += 4. * n * uR * M;
+        return fErr;
+    };
+
+    // ----------------------------------------------
+    // candidates - same as CircMedianBruteForce, without consecutive duplicates
+    auto ForEachCandidate = [&](auto&& f) -> void
+    {
+        if (n % 2 == 0)           // even number of values
+        {
+            bool       bPrev = false;
+            CircVal<T> Prev;
+            auto Candidate = [&](const CircVal<T>& b)
+            {
+                if (bPrev && b == Prev)
+                    return;
+
+                bPrev = true;
+                Prev  = b;
+                f(b);
+            };
+
+            for (size_t m = 0; m < n; ++m)
+            {
+                const size_t     nn = (m+1 == n) ? 0 : m+1;
+                const CircVal<T> Sm = S[m], Sn = S[nn];
+                const double     d  = CircVal<T>::Sdist(Sm, Sn);
+
+                // average set of each two circular-consecutive values
+                Candidate(CircVal<T>((double)Sm + d / 2.));
+                if (d == -CircVal<T>::GetR() / 2.)
+                    Candidate(CircVal<T>((double)Sn + d / 2.));
+            }
+        }
+        else                      // odd number of values
+            for (size_t m = 0; m < n; ++m)
+                if (m == 0 || S[m] != S[m-1])
+                    f(CircVal<T>(S[m]));
+    };
+
+    // a candidate whose direct sum is minimal has a lower bound <= the minimal upper bound
+    double fMinUpper = numeric_limits<double>::max();
+    ForEachCandidate([&](const CircVal<T>& b)
+    {
+        const SumDistT A      = SumDist(b);
+        const double   fUpper = A.fSum + A.fErr;
+        fMinUpper = min(fMinUpper, fUpper + ErrExact(fUpper, A.nW));
+    });
+
+    double fMinSumExact = numeric_limits<double>::max();
+    ForEachCandidate([&](const CircVal<T>& b)
+    {
+        const SumDistT A      = SumDist(b);
+        const double   fUpper = A.fSum + A.fErr;
+        if (A.fSum - A.fErr - ErrExact(fUpper, A.nW) > fMinUpper)
+            return;
+
+        const double fSum = SumDistExact(b);
+             if (fSum == fMinSumExact)              X.emplace(b);
+        else if (fSum <  fMinSumExact) { X.clear(); X.emplace(b); fMinSumExact = fSum; }
+    });
+}
+
+// calculate median set of circular values, given ascendingly sorted values
+// S      : values of A [T::L, T::H), ascendingly sorted
+// X      : set of median values (set<CircVal<T>> or CircValSmallSet<T>) - CircMedianBruteForce's set of S
+// Scratch: buffer for prefix sums (resized to 2*(S.size()+1); no allocation if its capacity suffices)
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T, typename ResultSet>
+void CircMedianSorted(span<const double> S, ResultSet& X, vector<double>& Scratch)
+{
+    CircMedianSorted<T>(S, X, Scratch, [S](const CircVal<T>& b)
+    {
+        double fSum = 0.;         // sum(|Sdist(a, b)|)
+        for (const double a : S)
+            fSum += abs(CircVal<T>::Sdist(b, CircVal<T>(a)));
+        return fSum;
+    });
+}
+
+// calculate median set of circular values, given ascendingly sorted values
+// return set of median values
+template<typename T>
+set<CircVal<T>> CircMedianSorted(span<const double> S, vector<double>& Scratch)
+{
+    set<CircVal<T>> X;
+    CircMedianSorted<T>(S, X, Scratch);
+    return X;
+}
+
+// ==========================================================================
+// calculate median set of circular values
+// the values are sorted once, and then the candidates are swept by CircMedianSorted: O(n*log(n))
+// X      : set of median values (set<CircVal<T>> or CircValSmallSet<T>)
+// Scratch: caller-owned buffers
+// T is a circular value type defined with the CircValTypeDef macro
+// A may also be a zero-copy view of a CircValArray (CircValArray::View())
+template<typename T, typename Real, typename ResultSet>
+void CircMedian(span<const CircVal<T, Real>> A, ResultSet& X, CircStatScratch& Scratch)
+{
+    vector<double>& S = Scratch.Angles; // A, sorted
+    S.assign(A.begin(), A.end());
+
+    sort(S.begin(), S.end());
+
+    // the sums of the remaining candidates are calculated over A, as CircMedianBruteForce(A)
+    CircMedianSorted<T, Real>(S, X, Scratch.Buffer, [A](const CircVal<T>& b)
+    {
+        const CircVal<T, Real> bb = b;
+        double fSum = 0.;         // sum(|Sdist(a, b)|)
+        for (const auto& a : A)
+            fSum += abs(CircVal<T, Real>::Sdist(bb, a));
+        return fSum;
+    });
+}
+
+template<typename T, typename Real, typename ResultSet>
+void CircMedian(vector<CircVal<T, Real>> const& A, ResultSet& X, CircStatScratch& Scratch)
+{
+    CircMedian(span<const CircVal<T, Real>>(A), X, Scratch);
+}
+
+// calculate median set of circular values
+// return set of median values
+template<typename T, typename Real>
+set<CircVal<T, Real>> CircMedian(span<const CircVal<T, Real>> A)
+{
+    set<CircVal<T, Real>> X;
+    CircStatScratch Scratch;
+    CircMedian(A, X, Scratch);
+    return X;
+}
+
+template<typename T, typename Real>
+set<CircVal<T, Real>> CircMedian(vector<CircVal<T, Real>> const& A)
+{
+    return CircMedian(span<const CircVal<T, Real>>(A));
+}
+
+// ==========================================================================
+// sliding window of circular values: the last nMaxCount values, and/or the values of the last fMaxAge time units
+// calculates the average set (as CircAverage2) and the median set (as CircMedianSorted) of the values in the window
+// Push/Pop: O(log(n)). GetAvrg: O(n). GetMedian: O(n*log(n))
+// the window's values are kept sorted; their nodes and the queries' buffers are recycled,
+// so once the window reached its steady-state size, Push/Pop allocate nothing, and GetAvrg/GetMedian allocate only their results
+// (nothing, if the results are collected in a reused CircValSmallSet)
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+class CircSlidingWindow
+{
+    struct Sample
+    {
+        double fVal ; // [T::L, T::H)
+        double fTime;
+    };
+
+    size_t                                  m_nMaxCount    ; // 0: unlimited
+    double                                  m_fMaxAge      ; // 0: unlimited
+    vector<Sample>                          m_Ring         ; // samples in the window, by order of arrival (circular buffer)
+    size_t                                  m_nHead        ; // index of oldest sample in m_Ring
+    size_t                                  m_nCount       ; // number of samples in the window
+    pmr::unsynchronized_pool_resource       m_Pool         ; // recycles the nodes of m_Sorted
+    pmr::multiset<double>                   m_Sorted       ; // values in the window, ascendingly sorted
+    mutable vector<double>                  m_Scratch1     ; // query buffers
+    mutable vector<double>                  m_Scratch2     ;
+
+    void PushBack(const Sample& s)
+    {
+        if (m_nCount == m_Ring.size()) // full - grow (time-limited window only)
+        {
+            vector<Sample> Ring(max<size_t>(2*m_Ring.size(), 16));
+            for (size_t i = 0; i < m_nCount; ++i)
+                Ring[i] = m_Ring[(m_nHead + i) % m_Ring.size()];
+
+            m_Ring.swap(Ring);
+            m_nHead = 0;
+        }
+
+        m_Ring[(m_nHead + m_nCount) % m_Ring.size()] = s;
+        ++m_nCount;
+    }
+
+public:
+    // nMaxCount: max number of values in the window (0: unlimited)
+    // fMaxAge  : max age of values in the window, in time units of Push (0: unlimited)
+    explicit CircSlidingWindow(size_t nMaxCount, double fMaxAge = 0.)
+        : m_nMaxCount(nMaxCount), m_fMaxAge(fMaxAge), m_Ring(nMaxCount), m_nHead(0), m_nCount(0), m_Sorted(&m_Pool)
+    {
+        assert(nMaxCount > 0 || fMaxAge > 0.);
+        m_Scratch1.reserve(nMaxCount + 1);
+        m_Scratch2.reserve(nMaxCount + 1);
+    }
+
+    CircSlidingWindow(const CircSlidingWindow&) = delete; // m_Sorted refers to m_Pool
+    CircSlidingWindow& operator=(const CircSlidingWindow&) = delete;
+
+    // add a value; values which are out of the window are removed
+    // fTime should be non-decreasing (ignored if fMaxAge is 0)
+    void Push(const CircVal<T>& c, double fTime = 0.)
+    {
+        if (m_nMaxCount && m_nCount == m_nMaxCount)
+            Pop();
+
+        PushBack({(double)c, fTime});
+        m_Sorted.emplace((double)c);
+
+        if (m_fMaxAge > 0.)
+            while (fTime - m_Ring[m_nHead].fTime > m_fMaxAge)
+                Pop();
+    }
+
+    // remove the oldest value
+    void Pop()
+    {
+        assert(m_nCount > 0);
+        m_Sorted.erase(m_Sorted.find(m_Ring[m_nHead].fVal));
+        m_nHead = (m_nHead + 1) % m_Ring.size();
+        --m_nCount;
+    }
+
+    void   Clear()       { while (m_nCount) Pop(); }
+    size_t Count() const { return m_nCount;         }
+
+    // return average set of the values in the window (empty set if the window is empty)
+    // same as CircAverage2 for the window's values, in ascending [0,360) order
+    set<CircVal<T>> GetAvrg() const
+    {
+        set<CircVal<T>> X;
+        GetAvrg(X);
+        return X;
+    }
+
+    // get average set of the values in the window (set<CircVal<T>> or CircValSmallSet<T>)
+    template<typename ResultSet>
+    void GetAvrg(ResultSet& X) const
+    {
+        X.clear();
+        if (m_nCount == 0)
+            return;
+
+        // convert to [0,360). the conversion is non-decreasing, except for a rotation at T::Z ...
+        vector<double>& Angles = m_Scratch1;
+        Angles.clear();
+
+        const auto iterZ = m_Sorted.lower_bound(T::Z);
+        for (auto iter = iterZ         ; iter != m_Sorted.end(); ++iter) Angles.emplace_back(CircVal<UnsignedDegRange>(CircVal<T>(*iter)));
+        for (auto iter = m_Sorted.begin(); iter != iterZ         ; ++iter) Angles.emplace_back(CircVal<UnsignedDegRange>(CircVal<T>(*iter)));
+
+        // ... and for values just below T::Z, which may be rounded up to 360 and wrapped to 0
+        rotate(Angles.begin(), is_sorted_until(Angles.begin(), Angles.end()), Angles.end());
+
+        const auto [fSum, fSumSqr] = BlockSums(Angles); // of all elements (as CircAverage2)
+
+        CircAverageSorted<T>(Angles, fSum, fSumSqr, X);
+    }
+
+    // return median set of the values in the window (empty set if the window is empty)
+    set<CircVal<T>> GetMedian() const
+    {
+        set<CircVal<T>> X;
+        GetMedian(X);
+        return X;
+    }
+
+    // get median set of the values in the window (set<CircVal<T>> or CircValSmallSet<T>)
+    template<typename ResultSet>
+    void GetMedian(ResultSet& X) const
+    {
+        m_Scratch2.assign(m_Sorted.begin(), m_Sorted.end());
+        CircMedianSorted<T>(m_Scratch2, X, m_Scratch1);
+    }
+};
+
+// ==========================================================================
+// tester for circular statistics
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+class CircStatTester
+{
+    // random sample of circular values; quantized samples produce many duplicates and ties
+    static vector<CircVal<T>> RandomSample(default_random_engine& rand_engine, size_t count, bool bQuantized)
+    {
+        uniform_real_distribution<double> c_uni_dist(T::L, T::H);
+        uniform_int_distribution <int   > q_uni_dist(0   , 7   );
+
+        vector<CircVal<T>> A(count);
+        for (auto& a : A)
+            a = bQuantized ? T::L + T::R * q_uni_dist(rand_engine) / 8. : c_uni_dist(rand_engine);
+
+        return A;
+    }
+
+public:
+    CircStatTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        default_random_engine rand_engine;
+        random_device         rnd_device ;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        for (size_t count : {1, 2, 3, 4, 5, 10, 100, 1000, 10000})
+            for (unsigned t = 0; t < 20; ++t)
+            {
+                const vector<CircVal<T>> A = RandomSample(rand_engine, count, t % 2 == 1);
+
+                assert(CircAverageLinear(A) == CircAverage2(A));
+            }
+
+        TestSmallSet   (rand_engine);
+        TestParallel   (rand_engine);
+        TestCompensated(rand_engine);
+        TestAccumulator(rand_engine);
+        TestMedian     (rand_engine);
+        TestWindow     (rand_engine);
+        TestFloat      (rand_engine);
+        TestMeanResultant(rand_engine);
+    }
+
+    // allocation-free overloads (CircValSmallSet, reused CircStatScratch) vs. set-returning functions
+    static void TestSmallSet(default_random_engine& rand_engine)
+    {
+        CircValSmallSet<T>    X ; // default inline capacity
+        CircValSmallSet<T, 1> X1; // spills to the heap on ties
+        CircStatScratch       Scratch;
+
+        uniform_real_distribution<double> w_uni_dist(0.1, 10.);
+
+        for (size_t count : {1, 2, 3, 4, 5, 10, 100, 1000, 10000})
+            for (unsigned t = 0; t < 6; ++t)
+            {
+                const vector<CircVal<T>> A = RandomSample(rand_engine, count, t % 2 == 1);
+
+                vector<pair<CircVal<T>, double>> WA;
+                vector<double>                   W ; // weights of A (columnar)
+                for (const auto& a : A)
+                {
+                    W .emplace_back(w_uni_dist(rand_engine));
+                    WA.emplace_back(a, W.back());
+                }
+
+                CircAverage        <T>(A , X , Scratch); assert(X  == CircAverage        (A ));
+                CircAverage        <T>(A , X1, Scratch); assert(X1 == CircAverage        (A ));
+                CircAverage2       <T>(A , X , Scratch); assert(X  == CircAverage2       (A ));
+                CircAverage2       <T>(A , X1, Scratch); assert(X1 == CircAverage2       (A ));
+                CircAverageLinear  <T>(A , X , Scratch); assert(X  == CircAverageLinear  (A ));
+                CircAverageLinear  <T>(A , X1, Scratch); assert(X1 == CircAverageLinear  (A ));
+                WeightedCircAverage<T>(WA, X , Scratch); assert(X  == WeightedCircAverage(WA));
+                WeightedCircAverage<T>(WA, X1, Scratch); assert(X1 == WeightedCircAverage(WA));
+                WeightedCircAverage<T>(A, W, X , Scratch); assert(X  == WeightedCircAverage(WA));
+                WeightedCircAverage<T>(A, W, X1, Scratch); assert(X1 == WeightedCircAverage(WA));
+                assert(WeightedCircAverage(A, W, CircSumMode::Compensated) == WeightedCircAverage(WA, CircSumMode::Compensated));
+
+                if (count <= 1000)
+                {
+                    CircMedian<T>(A, X , Scratch); assert(X  == CircMedian(A));
+                    CircMedian<T>(A, X1, Scratch); assert(X1 == CircMedian(A));
+                }
+            }
+    }
+
+    // parallel CircAverage2 vs. serial CircAverage2
+    static void TestParallel(default_random_engine& rand_engine)
+    {
+        CircValSmallSet<T> X;
+        CircStatScratch    Scratch;
+
+        for (size_t count : {size_t(1000), 2*CircStatBlockSize, 5*CircStatBlockSize + 1, size_t(300000)})
+            for (unsigned t = 0; t < 2; ++t)
+            {
+                const vector<CircVal<T>> A = RandomSample(rand_engine, count, t % 2 == 1);
+                const set<CircVal<T>>    S = CircAverage2(A);
+
+                for (unsigned nThreads : {1, 2, 3, 8})
+                {
+                    CircAverage2<T>(A, X, Scratch, nThreads);
+                    assert(X == S);
+                    assert(is_sorted(Scratch.Angles.begin(), Scratch.Angles.end()));
+                }
+
+                assert(CircAverage2(A, 0) == S);
+            }
+    }
+
+    // single-precision values: the statistics are calculated in double, from the values converted to [0,360).
+    // so the average sets are those of the converted values (in double), converted to CircVal<T, float>
+    static void TestFloat(default_random_engine& rand_engine)
+    {
+        CircValSmallSet<T, 4, float> X;
+        CircStatScratch              Scratch;
+
+        auto ToFloat = [](const set<CircVal<UnsignedDegRange>>& S) { return set<CircVal<T, float>>(S.begin(), S.end()); };
+
+        for (size_t count : {1, 2, 3, 4, 5, 10, 100, 1000, 10000})
+            for (unsigned t = 0; t < 6; ++t)
+            {
+                const vector<CircVal<T>>                A = RandomSample(rand_engine, count, t % 2 == 1);
+                const vector<CircVal<T, float>>         F(A.begin(), A.end()); // rounded to float
+                const vector<CircVal<UnsignedDegRange>> U(F.begin(), F.end()); // as converted by the statistics functions
+
+                assert(CircAverage      (F) == ToFloat(CircAverage      (U)));
+                assert(CircAverage2     (F) == ToFloat(CircAverage2     (U)));
+                assert(CircAverageLinear(F) == ToFloat(CircAverageLinear(U)));
+                assert(CircAverage2     (F, CircSumMode::Compensated) == ToFloat(CircAverage2(U, CircSumMode::Compensated)));
+
+                CircAverage2(F, X, Scratch);
+                assert(X == CircAverage2(F));
+
+                if (count <= 1000 && t % 2 == 0) // the same medians, up to the rounding of the values: the medians of F are
+                {                                // medians of A (and vice versa), up to the rounding of the sums of distances
+                    const set<CircVal<T, float>> M = CircMedian(F);
+                    const set<CircVal<T>>        N = CircMedian(A);
+
+                    auto SumDist = [](const auto& V, const CircVal<T>& b)
+                    {
+                        double fSum = 0.;
+                        for (const auto& a : V)
+                            fSum += abs(CircVal<T>::Sdist(b, CircVal<T>(a)));
+                        return fSum;
+                    };
+
+                    const double fTol     = 1e-6 * (count * T::R);
+                    const double fMinSumA = SumDist(A, *N.begin());
+                    const double fMinSumF = SumDist(F, *M.begin());
+
+                    assert(all_of(M.begin(), M.end(), [&](const CircVal<T>& m) { return SumDist(A, m) <= fMinSumA + fTol; }));
+                    assert(all_of(N.begin(), N.end(), [&](const CircVal<T>& n) { return SumDist(F, n) <= fMinSumF + fTol; }));
+                }
+            }
+    }
+
+    // CircMeanResultant vs. sums of sin,cos; parallel vs. serial; merged partial states vs. a single state
+    static void TestMeanResultant(default_random_engine& rand_engine)
+    {
+        auto AssertNear = [](const CircMeanResultantStats<T>& X, const CircMeanResultantStats<T>& Y)
+        {
+            assert(X.Count == Y.Count);
+            assert(abs(X.RBar - Y.RBar) <= 1e-12);
+            assert(abs(X.Var  - Y.Var ) <= 1e-12);
+            assert(X.RBar < 1e-6 || abs(CircVal<T>::Sdist(X.Mean, Y.Mean)) <= T::R * 1e-9); // the direction of a short resultant is ill-conditioned
+        };
+
+        for (size_t count : {size_t(1), size_t(2), size_t(3), size_t(5), size_t(10), size_t(100), size_t(1000), size_t(10000), 5*CircStatBlockSize + 1})
+            for (unsigned t = 0; t < 4; ++t)
+            {
+                const vector<CircVal<T>> A = RandomSample(rand_engine, count, t % 2 == 1);
+
+                double fSumSin = 0., fSumCos = 0.;
+                for (const auto& a : A)
+                {
+                    fSumSin += sin(a);
+                    fSumCos += cos(a);
+                }
+
+                const CircMeanResultantStats<T> X = CircMeanResultant(A);
+                const double                    fR = hypot(fSumSin, fSumCos) / count;
+
+                AssertNear(X, { count, atan2<T>(fSumSin, fSumCos), fR, 1. - fR, 0. });
+                assert(X.RBar >= 0. && X.RBar <= 1.);
+                assert(X.RBar == 1. ? X.StdDev == 0. : X.RBar == 0. ? isinf(X.StdDev) :
+                       abs(X.StdDev - sqrt(-2. * log(X.RBar)) * T::R / (2. * numbers::pi)) <= 1e-9 * X.StdDev);
+
+                for (unsigned nThreads : {2, 3, 8}) // the same sums, in the same order
+                {
+                    const CircMeanResultantStats<T> P = CircMeanResultant(A, nThreads);
+                    assert(P.Mean == X.Mean && P.RBar == X.RBar && P.StdDev == X.StdDev);
+                }
+
+                // map-reduce: states of 3 parts, merged
+                uniform_int_distribution<size_t> i_uni_dist(0, count);
+                size_t i1 = i_uni_dist(rand_engine), i2 = i_uni_dist(rand_engine);
+                if (i1 > i2)
+                    swap(i1, i2);
+
+                const span<const CircVal<T>> S(A);
+                CircMeanResultantState<T> S0, S1, S2, S3;
+                S0.Add(S.first(i1));
+                S1.Add(S.subspan(i1, i2 - i1));
+                for (const auto& a : S.subspan(i2))
+                    S2.Add(a);
+
+                S1.Merge(S2);
+                S3.Merge(S1);
+                S3.Merge(S0);
+                AssertNear(S3.Get(), X);
+            }
+
+        // identical values: RBar is 1, and the mean is the value. a pair of opposite values: RBar is 0
+        uniform_real_distribution<double> c_uni_dist(T::L, T::H);
+        for (unsigned t = 0; t < 100; ++t)
+        {
+            const CircVal<T> c = c_uni_dist(rand_engine);
+
+            const CircMeanResultantStats<T> X = CircMeanResultant(vector<CircVal<T>>(7, c));
+            assert(abs(X.RBar - 1.) <= 1e-15 && X.StdDev <= T::R * 1e-7);
+            assert(abs(CircVal<T>::Sdist(X.Mean, c)) <= T::R * 1e-15);
+
+            assert(CircMeanResultant(vector<CircVal<T>>{ c, c + CircVal<T>(T::Z + T::R / 2.) }).RBar <= 1e-13);
+        }
+
+        const CircMeanResultantStats<T> E = CircMeanResultantState<T>().Get();
+        assert(E.Count == 0 && E.RBar == 0. && E.Var == 1. && isinf(E.StdDev));
+
+        // single-precision values: the sums are in double, of the float sines and cosines
+        for (unsigned t = 0; t < 10; ++t)
+        {
+            const vector<CircVal<T>>        A = RandomSample(rand_engine, 1000, false);
+            const vector<CircVal<T, float>> F(A.begin(), A.end());
+
+            const CircMeanResultantStats<T, float> X = CircMeanResultant(F);
+            const CircMeanResultantStats<T>        Y = CircMeanResultant(vector<CircVal<T>>(F.begin(), F.end()));
+            assert(abs(X.RBar - Y.RBar) <= 1e-6);
+            assert(abs(CircVal<T>::Sdist(CircVal<T>(X.Mean), Y.Mean)) <= T::R * 1e-5);
+        }
+    }
+
+    // check if two sets of circular values are equal, up to rounding errors of the values
+    template<typename U>
+    static bool IsAlmostEqSet(const set<CircVal<U>>& X, const set<CircVal<U>>& Y)
+    {
+        return equal(X.begin(), X.end(), Y.begin(), Y.end(),
+                     [](const CircVal<U>& x, const CircVal<U>& y) { return abs(CircVal<U>::Sdist(x, y)) < 1e-9; });
+    }
+
+    // Compensated mode vs. an exact oracle (integer degrees, exact integer arithmetic), and vs. Fast mode
+    static void TestCompensated(default_random_engine& rand_engine)
+    {
+        typedef UnsignedDegRange U;
+
+        // integer degrees: step 45 (many exact ties) or 1
+        for (int nStep : {45, 1})
+            for (size_t count : {1, 2, 3, 4, 5, 8, 10, 100, 1000, 10000})
+                for (unsigned t = 0; t < 10; ++t)
+                {
+                    uniform_int_distribution<int> q_uni_dist(0, 360 / nStep - 1);
+                    uniform_int_distribution<int> w_uni_dist(1, 3);
+
+                    vector<CircVal<U>>                 A;       // values
+                    vector<pair<CircVal<U>, double>>   WA;      // values, integer weights
+                    vector<double>                     Wts;     // integer weights (columnar)
+                    vector<CircVal<U>>                 B;       // values, repeated by their weights
+                    vector<int64_t>                    Angles;  // sorted values
+
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        const int q = nStep * q_uni_dist(rand_engine), w = w_uni_dist(rand_engine);
+                        A .emplace_back(q);
+                        WA.emplace_back(CircVal<U>(q), w);
+                        Wts.emplace_back(w);
+                        B .insert(B.end(), w, CircVal<U>(q));
+                        Angles.emplace_back(q);
+                    }
+
+                    sort(Angles.begin(), Angles.end());
+
+                    // oracle: count*(sum of squares of differences) of each shift, in exact integer arithmetic
+                    const int64_t n = count;
+                    int64_t nSum = 0, nSumSqr = 0, nPrefix = 0;
+                    for (const int64_t a : Angles)
+                    {
+                        nSum    += a  ;
+                        nSumSqr += a*a;
+                    }
+
+                    int64_t        nMin = numeric_limits<int64_t>::max();
+                    vector<size_t> MinShifts;
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        if (i)
+                            nPrefix += Angles[i-1];
+
+                        const int64_t X = nSum + 360*(int64_t)i;
+                        const int64_t D = n*(nSumSqr + 720*nPrefix + 129600*(int64_t)i) - X*X;
+                        if      (D <  nMin) { nMin = D; MinShifts = {i}; }
+                        else if (D == nMin)             MinShifts.emplace_back(i);
+                    }
+
+                    set<CircVal<U>> Oracle;
+                    for (const size_t i : MinShifts)
+                        Oracle.emplace(CircVal<U>((double)(nSum + 360*(int64_t)i) / count));
+
+                    assert(CircAverage2(A, CircSumMode::Compensated) == Oracle);
+                    assert(IsAlmostEqSet(CircAverage(A, CircSumMode::Compensated), Oracle));
+
+                    const set<CircVal<U>> W = WeightedCircAverage(WA, CircSumMode::Compensated);
+                    assert(IsAlmostEqSet(W, CircAverage(B, CircSumMode::Compensated)));
+                    assert(W == WeightedCircAverage(A, Wts, CircSumMode::Compensated));
+                }
+
+        // antipodal values: two averages; near-ties in Fast mode, due to rounding errors
+        uniform_real_distribution<double> c_uni_dist(0., 180.);
+        for (size_t m : {10, 1000, 100000})
+        {
+            const double       c = c_uni_dist(rand_engine);
+            vector<CircVal<U>> A(m, CircVal<U>(c));
+            A.insert(A.end(), m, CircVal<U>(c + 180.));
+
+            assert(CircAverage2(A, CircSumMode::Compensated).size() == 2);
+            assert(CircAverage (A, CircSumMode::Compensated).size() == 2);
+        }
+
+        // continuous values of type T: no ties, so both modes should find the same average
+        for (size_t count : {1, 2, 3, 10, 100, 1000, 10000})
+            for (unsigned t = 0; t < 10; ++t)
+            {
+                const vector<CircVal<T>> A = RandomSample(rand_engine, count, false);
+                const set<CircVal<T>>    X = CircAverage2(A, CircSumMode::Compensated);
+
+                assert(X.size() == 1);
+                assert(IsAlmostEqSet(X, CircAverage2(A)));
+                assert(IsAlmostEqSet(X, CircAverage (A, CircSumMode::Compensated)));
+            }
+    }
+
+    // CircMedian(A) is CircMedianBruteForce(A); CircMedianSorted(S) is CircMedianBruteForce(S) - the sums are rounded in
+    // the order of the values, so the median set of ties may depend on it
+    static void TestMedian(default_random_engine& rand_engine)
+    {
+        vector<double> Scratch;
+
+        for (size_t count : {1, 2, 3, 4, 5, 6, 7, 10, 11, 100, 101, 1000, 10000})
+            for (unsigned t = 0; t < (count < 10000 ? 20u : 2u); ++t)
+            {
+                const vector<CircVal<T>> A = RandomSample(rand_engine, count, t % 2 == 1);
+
+                vector<double> S(A.begin(), A.end());
+                sort(S.begin(), S.end());
+
+                assert(CircMedian(A) == CircMedianBruteForce(A));
+                if (count < 10000)
+                    assert(CircMedianSorted<T>(S, Scratch) == CircMedianBruteForce(vector<CircVal<T>>(S.begin(), S.end())));
+            }
+
+        // constant values, and values clustered within 1e-9 (around a random center, and across the wrap at L)
+        uniform_real_distribution<double> center_dist(T::L, T::H), offset_dist(-1e-9, 1e-9);
+        for (size_t count : {1000, 1001, 10000})
+            for (unsigned t = 0; t < 3; ++t)
+            {
+                const double c = (t == 2) ? T::L : center_dist(rand_engine);
+
+                vector<CircVal<T>> A(count, CircVal<T>(c));
+                assert(CircMedian(A) == CircMedianBruteForce(A) && CircMedian(A).size() == 1);
+
+                if (count < 10000)
+                {
+                    for (auto& a : A)
+                        a = c + offset_dist(rand_engine);
+
+                    assert(CircMedian(A) == CircMedianBruteForce(A));
+                }
+            }
+    }
+
+    // CircSlidingWindow vs. CircAverage2, CircMedianBruteForce
+    static void TestWindow(default_random_engine& rand_engine)
+    {
+        for (bool bQuantized : {false, true})
+        {
+            const vector<CircVal<T>> Pool = RandomSample(rand_engine, 1000, bQuantized);
+
+            CircSlidingWindow<T> W1(50     ); // last 50 values
+            CircSlidingWindow<T> W2( 0, 20.); // values of last 20 time units
+
+            assert(W1.GetAvrg().empty() && W1.GetMedian().empty());
+
+            for (size_t i = 0; i < Pool.size(); ++i)
+            {
+                W1.Push(Pool[i]);
+                W2.Push(Pool[i], i * 0.7);
+
+                for (const auto& [W, nCount] : { pair<CircSlidingWindow<T>*, size_t>(&W1, min<size_t>(i+1, 50)),
+                                                 pair<CircSlidingWindow<T>*, size_t>(&W2, min<size_t>(i+1, 29)) })
+                {
+                    assert(W->Count() == nCount);
+                    if (i % 7 != 0)
+                        continue;
+
+                    const vector<CircVal<T>> A(Pool.begin() + (i+1-nCount), Pool.begin() + (i+1)); // window's values
+
+                    // CircAverage2 input: window's values in ascending [0,360) order
+                    vector<CircVal<T>> B = A;
+                    sort(B.begin(), B.end(), [](const CircVal<T>& a, const CircVal<T>& b) { return CircVal<UnsignedDegRange>(a) < CircVal<UnsignedDegRange>(b); });
+
+                    assert(W->GetAvrg() == CircAverage2(B));
+
+                    // CircMedianSorted input: window's values in ascending order
+                    vector<CircVal<T>> C = A;
+                    sort(C.begin(), C.end());
+
+                    assert(W->GetMedian() == CircMedianBruteForce(C));
+
+                    CircValSmallSet<T> X;
+                    W->GetAvrg  (X); assert(X == W->GetAvrg  ());
+                    W->GetMedian(X); assert(X == W->GetMedian());
+                }
+            }
+        }
+    }
+
+    // CircAverageAccumulator vs. CircAverage2, for a random sequence of Add/Remove operations
+    static void TestAccumulator(default_random_engine& rand_engine)
+    {
+        for (bool bQuantized : {false, true})
+        {
+            const vector<CircVal<T>> Pool = RandomSample(rand_engine, 300, bQuantized);
+            uniform_int_distribution<size_t> i_uni_dist(0, Pool.size() - 1);
+
+            CircAverageAccumulator<T> Acc;
+            multiset<CircVal<T>>      Vals;  // accumulated values
+
+            assert(Acc.GetAvrg().empty());
+
+            for (unsigned t = 0; t < 2000; ++t)
+            {
+                const CircVal<T> c = Pool[i_uni_dist(rand_engine)];
+
+                if (t % 3 == 2)              // remove
+                {
+                    auto iter = Vals.find(c);
+                    assert(Acc.Remove(c) == (iter != Vals.end()));
+                    if (iter != Vals.end())
+                        Vals.erase(iter);
+                }
+                else                         // add
+                {
+                    Acc.Add(c);
+                    Vals.emplace(c);
+                }
+
+                assert(Acc.Count() == Vals.size());
+                if (!Vals.empty() && t % 10 == 0)
+                {
+                    // CircAverage2 input: accumulated values in ascending [0,360) order
+                    vector<CircVal<T>> A(Vals.begin(), Vals.end());
+                    sort(A.begin(), A.end(), [](const CircVal<T>& a, const CircVal<T>& b) { return CircVal<UnsignedDegRange>(a) < CircVal<UnsignedDegRange>(b); });
+                    assert(Acc.GetAvrg() == CircAverage2(A));
+
+                    CircValSmallSet<T> X;
+                    Acc.GetAvrg(X); assert(X == Acc.GetAvrg());
+                }
+            }
+        }
+    }
+};
@@ -4,8 +4,22 @@
 // classes defined here:
 // CircVal            - circular-value
 // CircValTester      - tester for CircVal class
+//
+// floating-point contraction: sincosN (SIMD kernels) is identical to sincos only if the headers are compiled without
+// floating-point contraction - gcc/clang: -ffp-contract=off (set by the CMake target circular; gcc contracts by default
+// also with -std=c++20); MSVC: the default /fp:precise (not /fp:contract, /fp:fast). Wrap and WrapN are identical with
+// any setting (the multiply-subtracts are fused explicitly where the target has an FMA - MulSub)
 // ==========================================================================
 
+// LK  16-Oct-2026: Add sincos/sincosN - fused sine and cosine with quadrant-based argument reduction (SIMD kernel in CircSimd.h)
+
+// LK  16-Oct-2026: Template CircVal on the scalar type (CircVal<Type, float>: single-precision values), double by default
+
+// LK  16-Oct-2026: Compile-time specialized Wrap: power-of-two ranges (exact 1/R scaling), [0,R) and [-R/2,R/2) ranges
+//                  (branchless round-to-nearest); fold the range ratio of cross-type conversions at compile time
+
+// LK  16-Oct-2026: Add WrapN - batch wrapping of contiguous arrays (SIMD kernels in CircSimd.h)
+
 // DRNadler 17-Jan-2026: Replace CircValTypeDef macro with CircValType template.
 
 // LK   2-Jan-2026: Replace FP comparison (==) with std::equal_to to avoid triggering -Wfloat-equal
@@ -20,10 +34,15 @@
 
 #include <random>
 #include <numbers>         // std::numbers::pi
+#include <span>            // std::span
+#include <vector>
+#include <algorithm>       // std::equal
+#include <type_traits>     // std::common_type_t, std::type_identity_t
 #include <assert.h>
 
 #include "FPCompare.h"
-#include "CircHelper.h"   // Mod
+#include "CircHelper.h"   // Mod, ModInv, MulSub, IsPow2, SinCosQuadrant
+#include "CircSimd.h"     // SimdWrap, SimdWrapNearest, SimdSinCos
 
 // ==========================================================================
 // use this template to define a circular-value type
@@ -38,6 +57,12 @@ struct CircValType
     static constexpr double Z = Z_;            // zero-value
     static constexpr double R = H_ - L_;       // range
     static constexpr double R_2 = (H_ - L_) / 2.0; // half range
+    static constexpr double C = (L_ + H_) / 2.0; // center of the range
+    static constexpr double InvR = 1.0 / (H_ - L_); // 1/R
+
+    // compile-time properties of the range, used by CircVal<>::Wrap to select a specialized path
+    static constexpr bool IsPow2R = IsPow2(H_ - L_); // R= 2^k: x*(1/R) == x/R
+    static constexpr bool IsStdRange = std::equal_to<double>{}(L_, 0.0) || std::equal_to<double>{}(L_, -H_); // [0,R) or [-R/2,R/2) - e.g. the degree and radian ranges
 
     static_assert(H_ >  L_, "CircValType: invalid range (require H > L)");
     static_assert(Z_ >= L_, "CircValType: invalid zero (require Z >= L)");
@@ -55,71 +80,195 @@ using TestRange0 = CircValType<  3.0, 10.0,  5.3>;
 using TestRange1 = CircValType< -3.0, 10.0, -3.0>;
 using TestRange2 = CircValType< -3.0, 10.0,  9.9>;
 using TestRange3 = CircValType<-13.0, -3.0, -5.3>;
+using TestRange4 = CircValType< -3.0,  5.0,  1.5>; // power-of-two range
 
 // ==========================================================================
 // circular value
 // Type should be defined using the CircValType template
-template <typename Type>
+// Real is the scalar type of the value: double, or float (half the memory - for large, memory-bound arrays).
+// the range constants are rounded to Real. conversions between scalar types are computed in double
+template <typename Type, typename Real = double>
 class CircVal
 {
-    double val; // actual value [Type::L, Type::H)
+    static_assert(std::is_floating_point_v<Real>, "CircVal: floating-point scalar type expected");
+
+    template <typename, typename> friend class CircVal;
+
+    Real val; // actual value [L, H)
+
+    // the range, in the scalar type. for double, identical to Type's constants
+    static constexpr Real L    = Real(Type::L);
+    static constexpr Real H    = Real(Type::H);
+    static constexpr Real Z    = Real(Type::Z);
+    static constexpr Real R    = H - L;
+    static constexpr Real R_2  = R / Real(2);
+    static constexpr Real C    = Real(Type::C);
+    static constexpr Real InvR = Real(1) / R;
+
+    // Wrap by rounding to the nearest multiple of R: [0,R) and [-R/2,R/2) ranges (power-of-two ranges keep the exact Mod path)
+    static constexpr bool NearestWrap = Type::IsStdRange && !Type::IsPow2R;
+
+    // sine/cosine argument reduction (SinCosQuadrant), in double: quarter turns of the range
+    // radian ranges: pi/2 split into 3 parts (|q| <= 4, so q*Q1 and q*Q2 are exact), so the reduction is accurate near multiples of pi/2
+    // other ranges : R/4 - the reduction is exact, and the results at multiples of R/4 (e.g. 90 degrees) are exact
+    static constexpr bool   RadRange  = std::equal_to<double>{}(Type::R, 2 * std::numbers::pi);
+    static constexpr double TrigQ1    = RadRange ? 0x1.921fb54442d18p+0   : Type::R / 4.; // pi/2 = Q1+Q2+Q3: 50 + 50 + 53 bits
+    static constexpr double TrigQ2    = RadRange ? 0x1.1a62633145c00p-54  : 0.;
+    static constexpr double TrigQ3    = RadRange ? 0x1.b839a252049c1p-104 : 0.;
+    static constexpr double TrigInvQ  = 4. / Type::R;
+    static constexpr double TrigScale = RadRange ? 1. : std::numbers::pi / (Type::R / 2.);
+
+    // convert the value of a circular value of another type: Pdist(Z2, c) scaled to this range, + Z
+    // computed in the wider scalar type. the range ratio is folded at compile time (a ratio of 1 is skipped);
+    // with Z2 == L2 (no shift), Pdist(Z2, c) is c-L2
+    template<typename Type2, typename Real2>
+    inline static Real Convert(const CircVal<Type2, Real2>& c)
+    {
+        using W  = std::common_type_t<Real, Real2>;
+        using C2 = CircVal<Type2, Real2>;
+        constexpr W fScale = W(R) / W(C2::R);
+
+        const W r2 = W(c.val);
+
+        W d;
+        if constexpr (std::equal_to<double>{}(Type2::Z, Type2::L)) d = r2 - W(C2::L);
+        else                                                         d = r2 >= W(C2::Z) ? r2 - W(C2::Z) : W(C2::R) - W(C2::Z) + r2; // Pdist(Z2, c)
+
+        Real v;
+        if constexpr (std::equal_to<W>{}(fScale, W(1))) v = Real(d          + W(Z));
+        else                                             v = Real(d * fScale + W(Z));
+
+        return v < H ? v : v - R; // v in [Z, Z+R]: the result of Wrap(v), without the general case
+    }
 
     // ---------------------------------------------
 public:
-    inline static double GetL() { return Type::L; }
-    inline static double GetH() { return Type::H; }
-    inline static double GetZ() { return Type::Z; }
-    inline static double GetR() { return Type::R; }
+    inline static Real GetL() { return L; }
+    inline static Real GetH() { return H; }
+    inline static Real GetZ() { return Z; }
+    inline static Real GetR() { return R; }
 
     // ---------------------------------------------
-    inline static bool IsInRange(double r)
+    inline static bool IsInRange(Real r)
     {
-        return (r >= Type::L && r < Type::H);
+        return (r >= L && r < H);
     }
 
-    // 'wraps' circular-value to [Type::L,Type::H)
-    inline static double Wrap(double r)
+    // 'wraps' circular-value to [L,H)
+    inline static Real Wrap(Real r)
     {
-        // the next lines are for optimization and improved accuracy only
-        if (r >= Type::L)
+        if constexpr (NearestWrap)
         {
-                 if (r <  Type::H        ) return r        ;
-            else if (r <  Type::H+Type::R) return r-Type::R;
+            // branchless: subtract the multiple of R nearest to r-C. values in the range are returned as is
+            const Real m = MulSub(r, RoundNearest((r - C) * InvR), R);
+
+            // handle boundary cases resulting from floating-point limited accuracy (and r-C == R/2: rounded to even)
+            const Real m1 = m < L ? m + R : m;
+            return m1 >= H ? m1 - R : m1;
         }
         else
-                 if (r >= Type::L-Type::R) return r+Type::R;
+        {
+            // the next lines are for optimization and improved accuracy only
+            if (r >= L)
+            {
+                     if (r <  H  ) return r  ;
+                else if (r <  H+R) return r-R;
+            }
+            else
+                     if (r >= L-R) return r+R < H ? r+R : L; // r+R may round to H (as Mod)
+
+            // general case
+            if constexpr (Type::IsPow2R)
+                return ModInv(r - L, R, InvR) + L; // exact scaling: identical to Mod, without the division
+            else
+                return Mod   (r - L, R      ) + L;
+        }
+    }
 
-        // general case
-        return Mod(r - Type::L, Type::R) + Type::L;
+    // 'wraps' n contiguous floating-point values to [L,H). in and out may be the same array
+    // the result is identical to calling Wrap() for each value
+    // the SIMD kernels are double; float arrays are wrapped by the (branchless, auto-vectorizable) scalar loop
+    inline static void WrapN(const Real* in, Real* out, size_t n)
+    {
+        size_t i = 0;
+        if constexpr (std::is_same_v<Real, double>)
+        {
+            if constexpr (NearestWrap) i = SimdWrapNearest(in, out, n, L, H, R, C, InvR);
+            else                       i = SimdWrap       (in, out, n, L, H, R         );
+        }
+
+        for (; i < n; ++i)
+            out[i] = Wrap(in[i]);
+    }
+
+    inline static void WrapN(std::span<const Real> in, std::span<Real> out)
+    {
+        assert(in.size() == out.size());
+        WrapN(in.data(), out.data(), in.size());
+    }
+
+    inline static void WrapN(std::span<Real> inout) // in-place
+    {
+        WrapN(inout.data(), inout.data(), inout.size());
     }
 
     // ---------------------------------------------
     // the length of shortest directed walk from c1 to c2
-    // return value is in [-Type::R/2, Type::R/2)
-    inline static double Sdist(const CircVal& c1, const CircVal& c2)
+    // return value is in [-R/2, R/2)
+    inline static Real Sdist(const CircVal& c1, const CircVal& c2)
     {
-        double d = c2.val-c1.val;
-        if (d <  -Type::R_2) { return d + Type::R; };
-        if (d >=  Type::R_2) { return d - Type::R; };
-                             { return d          ; };
+        Real d = c2.val-c1.val;
+        if (d <  -R_2) { return d + R; };
+        if (d >=  R_2) { return d - R; };
+                       { return d    ; };
     }
 
     // the length of the shortest increasing walk from c1 to c2
-    // return value is in [0, Type::R)
-    inline static double Pdist(const CircVal& c1, const CircVal& c2)
+    // return value is in [0, R)
+    inline static Real Pdist(const CircVal& c1, const CircVal& c2)
+    {
+        return c2.val >= c1.val ? c2.val-c1.val : R-c1.val+c2.val;
+    }
+
+    // ---------------------------------------------
+    // sine and cosine of c, fused (a full turn is R; Z is angle 0)
+    // quadrant-based argument reduction and the Cephes polynomials (SinCosQuadrant), evaluated in double:
+    // max error, relative to the exact sine/cosine of the angle c-Z (in double): 2 ULP for the degree and radian ranges, 2.5 ULP
+    // for other ranges (whose scale to radians is rounded); float: 1 ULP - see CircValTester::TestSinCos.
+    // results at multiples of a quarter turn are exactly 0 and +-1 (except for radian ranges, where a quarter turn is not representable)
+    inline static void SinCos(const CircVal& c, Real& s, Real& co)
     {
-        return c2.val >= c1.val ? c2.val-c1.val : Type::R-c1.val+c2.val;
+        double sd, cd;
+        SinCosQuadrant(double(c.val) - double(Z), TrigInvQ, TrigQ1, TrigQ2, TrigQ3, TrigScale, sd, cd);
+        s  = Real(sd);
+        co = Real(cd);
+    }
+
+    // sine and cosine of n contiguous circular values. the result is identical to calling SinCos() for each value
+    // (double: SIMD kernel in CircSimd.h)
+    inline static void SinCosN(const CircVal* in, Real* s, Real* c, size_t n)
+    {
+        size_t i = 0;
+        if constexpr (std::is_same_v<Real, double>)
+        {
+            static_assert(sizeof(CircVal) == sizeof(double) && std::is_standard_layout_v<CircVal>,
+                          "CircVal::SinCosN: CircVal is expected to wrap a single double");
+            i = SimdSinCos(reinterpret_cast<const double*>(in), s, c, n, Z, TrigInvQ, TrigQ1, TrigQ2, TrigQ3, TrigScale);
+        }
+
+        for (; i < n; ++i)
+            SinCos(in[i], s[i], c[i]);
     }
 
     // ---------------------------------------------
-    CircVal() : val(Type::Z)
+    CircVal() : val(Z)
     {
     }
 
     // construction based on a floating-point value
     // floating-point is wrapped into the range
     // to translate a floating-point such that 0 is mapped to Type::Z, call ToC()
-    CircVal(double r) : val(Wrap(r))
+    CircVal(Real r) : val(Wrap(r))
     {
     }
 
@@ -128,15 +277,15 @@ public:
     {
     }
 
-    // construction based on a circular value of another type
+    // construction based on a circular value of another type (or of another scalar type)
     // sample use: CircVal<SignedRadRange> c= c2;   -or-   CircVal<SignedRadRange> c(c2);
-    template<typename Type2>
-    CircVal(const CircVal<Type2>& c) : val(Wrap(c.Pdist(c.GetZ(), c) * Type::R/Type2::R + Type::Z))
+    template<typename Type2, typename Real2>
+    CircVal(const CircVal<Type2, Real2>& c) : val(Convert(c))
     {
     }
 
     // ---------------------------------------------
-    operator double() const
+    operator Real() const
     {
         return val;
     }
@@ -145,69 +294,89 @@ public:
     // assignment from a floating-point value
     // floating-point is wrapped into the range
     // to translate a floating-point such that 0 is mapped to Type::Z, call ToC()
-    CircVal& operator= (double r)
+    CircVal& operator= (Real r)
     {
         val = Wrap(r);
         return *this;
     }
 
     // assignment from another type of circular value
-    template<typename Type2>
-    CircVal& operator= (const CircVal<Type2>& c)
+    template<typename Type2, typename Real2>
+    CircVal& operator= (const CircVal<Type2, Real2>& c)
     {
-        val = Wrap(c.Pdist(c.GetZ(), c) * Type::R/Type2::R + Type::Z);
+        val = Convert(c);
         return *this;
     }
 
     // ---------------------------------------------
     // convert circular-value c to real-value [L-Z,H-Z). Z is converted to 0
-    friend double ToR(const CircVal& c) { return c.val - Type::Z; }
+    friend Real ToR(const CircVal& c) { return c.val - Z; }
 
     // ---------------------------------------------
-    const CircVal  operator+ (                ) const { return val;                                               }
-    const CircVal  operator- (                ) const { return Wrap(Type::Z - Sdist(Type::Z, val));               } // return negative circular value
-    const CircVal  operator~ (                ) const { return Wrap(val + Type::R_2              );               } // return opposite circular-value
-
-    const CircVal  operator+ (const CircVal& c) const { return Wrap(val + c.val         - Type::Z);               }
-    const CircVal  operator- (const CircVal& c) const { return Wrap(val - c.val         + Type::Z);               }
-    const CircVal  operator* (const double&  r) const { return Wrap((val - Type::Z) * r + Type::Z);               }
-    const CircVal  operator/ (const double&  r) const { return Wrap((val - Type::Z) / r + Type::Z);               }
-
-          CircVal& operator+=(const CircVal& c)       { val = Wrap(val + c.val          - Type::Z); return *this; }
-          CircVal& operator-=(const CircVal& c)       { val = Wrap(val - c.val          + Type::Z); return *this; }
-          CircVal& operator*=(const double&  r)       { val = Wrap((val - Type::Z) * r  + Type::Z); return *this; }
-          CircVal& operator/=(const double&  r)       { val = Wrap((val - Type::Z) / r  + Type::Z); return *this; }
-
-          CircVal& operator =(const CircVal& c)       { val = c.val                               ; return *this; }
-          bool     operator==(const CircVal& c) const { return std::equal_to<decltype(val)>{}(val, c.val);        } // std::equal_to instead of == to avoid triggering -Wfloat-equal
-          bool     operator!=(const CircVal& c) const { return !(*this == c);                                     }
+    const CircVal  operator+ (                ) const { return val;                                   }
+    const CircVal  operator- (                ) const { return Wrap(Z - Sdist(Z, val));               } // return negative circular value
+    const CircVal  operator~ (                ) const { return Wrap(val + R_2        );               } // return opposite circular-value
+
+    const CircVal  operator+ (const CircVal& c) const { return Wrap(val + c.val   - Z);               }
+    const CircVal  operator- (const CircVal& c) const { return Wrap(val - c.val   + Z);               }
+    const CircVal  operator* (const Real&    r) const { return Wrap((val - Z) * r + Z);               }
+    const CircVal  operator/ (const Real&    r) const { return Wrap((val - Z) / r + Z);               }
+
+          CircVal& operator+=(const CircVal& c)       { val = Wrap(val + c.val    - Z); return *this; }
+          CircVal& operator-=(const CircVal& c)       { val = Wrap(val - c.val    + Z); return *this; }
+          CircVal& operator*=(const Real&    r)       { val = Wrap((val - Z) * r  + Z); return *this; }
+          CircVal& operator/=(const Real&    r)       { val = Wrap((val - Z) / r  + Z); return *this; }
+
+          CircVal& operator =(const CircVal& c)       { val = c.val                   ; return *this; }
+          bool     operator==(const CircVal& c) const { return std::equal_to<decltype(val)>{}(val, c.val); } // std::equal_to instead of == to avoid triggering -Wfloat-equal
+          bool     operator!=(const CircVal& c) const { return !(*this == c);                         }
     
     // note that two circular values can be compared in several different ways.
     // check carefully if this is really what you need!
-    bool           operator> (const CircVal& c) const { return val >  c.val;                                      }
-    bool           operator>=(const CircVal& c) const { return val >= c.val;                                      }
-    bool           operator< (const CircVal& c) const { return val <  c.val;                                      }
-    bool           operator<=(const CircVal& c) const { return val <= c.val;                                      }
+    bool           operator> (const CircVal& c) const { return val >  c.val;                          }
+    bool           operator>=(const CircVal& c) const { return val >= c.val;                          }
+    bool           operator< (const CircVal& c) const { return val <  c.val;                          }
+    bool           operator<=(const CircVal& c) const { return val <= c.val;                          }
 };
 
 // ==========================================================================
-template <typename Type> static double        sin  (const CircVal<Type>& c) { return std::sin(ToR(CircVal<SignedRadRange>(c)));  }
-template <typename Type> static double        cos  (const CircVal<Type>& c) { return std::cos(ToR(CircVal<SignedRadRange>(c)));  }
-template <typename Type> static double        tan  (const CircVal<Type>& c) { return std::tan(ToR(CircVal<SignedRadRange>(c)));  }
-template <typename Type> static CircVal<Type> asin (double r              ) { return CircVal<SignedRadRange>(std::asin (r    )); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
-template <typename Type> static CircVal<Type> acos (double r              ) { return CircVal<SignedRadRange>(std::acos (r    )); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
-template <typename Type> static CircVal<Type> atan (double r              ) { return CircVal<SignedRadRange>(std::atan (r    )); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
-template <typename Type> static CircVal<Type> atan2(double r1, double r2  ) { return CircVal<SignedRadRange>(std::atan2(r1,r2)); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
-template <typename Type> static CircVal<Type> ToC  (double r              ) { return CircVal<Type>::Wrap(r + Type::Z);           } // convert real-value r to circular-value in the range. 0 is converted to Type.Z
+// the scalar type of the result is given explicitly (e.g. asin<SignedDegRange, float>(r)), double by default
+template <typename Real> using ScalarArg = std::type_identity_t<Real>; // not deduced from the argument
+
+template <typename Type, typename Real         > static Real                sin  (const CircVal<Type, Real>& c    ) { return std::sin(ToR(CircVal<SignedRadRange, Real>(c)));  }
+template <typename Type, typename Real         > static Real                cos  (const CircVal<Type, Real>& c    ) { return std::cos(ToR(CircVal<SignedRadRange, Real>(c)));  }
+template <typename Type, typename Real         > static Real                tan  (const CircVal<Type, Real>& c    ) { return std::tan(ToR(CircVal<SignedRadRange, Real>(c)));  }
+
+// fused sine and cosine, and their batch version (see CircVal::SinCos)
+template <typename Type, typename Real> static void sincos (const CircVal<Type, Real>& c, Real& s, Real& co) { CircVal<Type, Real>::SinCos(c, s, co); }
+template <typename Type, typename Real> static void sincosN(std::span<const CircVal<Type, Real>> in, ScalarArg<std::span<Real>> s, ScalarArg<std::span<Real>> c)
+{
+    assert(in.size() == s.size() && in.size() == c.size());
+    CircVal<Type, Real>::SinCosN(in.data(), s.data(), c.data(), in.size());
+}
+
+template <typename Type, typename Real = double> static CircVal<Type, Real> asin (ScalarArg<Real> r                ) { return CircVal<SignedRadRange, Real>(std::asin (r    )); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
+template <typename Type, typename Real = double> static CircVal<Type, Real> acos (ScalarArg<Real> r                ) { return CircVal<SignedRadRange, Real>(std::acos (r    )); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
+template <typename Type, typename Real = double> static CircVal<Type, Real> atan (ScalarArg<Real> r                ) { return CircVal<SignedRadRange, Real>(std::atan (r    )); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
+template <typename Type, typename Real = double> static CircVal<Type, Real> atan2(ScalarArg<Real> r1, ScalarArg<Real> r2) { return CircVal<SignedRadRange, Real>(std::atan2(r1,r2)); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
+template <typename Type, typename Real = double> static CircVal<Type, Real> ToC  (ScalarArg<Real> r                ) { return CircVal<Type, Real>::Wrap(r + Real(Type::Z));     } // convert real-value r to circular-value in the range. 0 is converted to Type.Z
 
 // ==========================================================================
 // tester for CircVal class
-template <typename Type>
+template <typename Type, typename Real = double>
 class CircValTester
 {
+    // single-precision comparisons: tolerance relative to R (circular values) or to the magnitude (floating-points).
+    // FPCompare's ULP-based comparisons are for double
+    static constexpr bool   bFloat    = std::is_same_v<Real, float>;
+    static constexpr double kFloatTol = 1e-4;
+
     // check if 2 circular-values are almost equal
-    inline static bool IsCircAlmostEq(const CircVal<Type>& c1, const CircVal<Type>& c2)
+    inline static bool IsCircAlmostEq(const CircVal<Type, Real>& c1, const CircVal<Type, Real>& c2)
     {
+        if constexpr (bFloat)
+            return std::abs((double)CircVal<Type, Real>::Sdist(c1, c2)) <= kFloatTol * Type::R;
+
         double r1 = c1;
         double r2 = c2;
 
@@ -221,14 +390,23 @@ class CircValTester
     }
 
     // assert that 2 circular-values are almost equal
-    inline static void AssertCircAlmostEq([[maybe_unused]]const CircVal<Type>& c1, [[maybe_unused]]const CircVal<Type>& c2)
+    inline static void AssertCircAlmostEq([[maybe_unused]]const CircVal<Type, Real>& c1, [[maybe_unused]]const CircVal<Type, Real>& c2)
     {
         assert(IsCircAlmostEq(c1, c2));
     }
 
+    // assert that 2 floating-points are almost equal
+    inline static void AssertAlmostEq([[maybe_unused]]double f, [[maybe_unused]]double g)
+    {
+        if constexpr (bFloat)
+            assert(std::abs(f - g) <= kFloatTol * std::max(1., std::max(std::abs(f), std::abs(g))));
+        else
+            ::AssertAlmostEq(f, g);
+    }
+
     inline static void Test()
     {
-        CircVal<Type> ZeroVal = Type::Z;
+        CircVal<Type, Real> ZeroVal = Type::Z;
 
         // --------------------------------------------------------
         AssertCircAlmostEq(ZeroVal       , -ZeroVal);
@@ -237,11 +415,11 @@ class CircValTester
         AssertAlmostEq    (cos(ZeroVal)  , 1.      );
         AssertAlmostEq    (tan(ZeroVal)  , 0.      );
 
-        AssertCircAlmostEq(asin<Type>(0.), ZeroVal );
-        AssertCircAlmostEq(acos<Type>(1.), ZeroVal );
-        AssertCircAlmostEq(atan<Type>(0.), ZeroVal );
+        AssertCircAlmostEq(asin<Type, Real>(0.), ZeroVal );
+        AssertCircAlmostEq(acos<Type, Real>(1.), ZeroVal );
+        AssertCircAlmostEq(atan<Type, Real>(0.), ZeroVal );
 
-        AssertCircAlmostEq(ToC<Type>(0)  , ZeroVal );
+        AssertCircAlmostEq(ToC<Type, Real>(0)  , ZeroVal );
         AssertAlmostEq    (ToR(ZeroVal)  , 0.      );
 
         // --------------------------------------------------------
@@ -255,14 +433,14 @@ class CircValTester
 
         for (unsigned i = 10000; i--;)
         {
-            CircVal<Type> c1(c_uni_dist(rand_engine)); // random circular value
-            CircVal<Type> c2(c_uni_dist(rand_engine)); // random circular value
-            CircVal<Type> c3(c_uni_dist(rand_engine)); // random circular value
-            double        r (r_uni_dist(rand_engine)); // random real     value [    0, 1000) - for testing *,/ operators
-            double        a1(t_uni_dist(rand_engine)); // random real     value [   -1,    1) - for testing asin,acos
-            double        a2(t_uni_dist(rand_engine)); // random real     value [-1000, 1000) - for testing atan
+            CircVal<Type, Real> c1(c_uni_dist(rand_engine)); // random circular value
+            CircVal<Type, Real> c2(c_uni_dist(rand_engine)); // random circular value
+            CircVal<Type, Real> c3(c_uni_dist(rand_engine)); // random circular value
+            Real          r (r_uni_dist(rand_engine)); // random real     value [    0, 1000) - for testing *,/ operators
+            Real          a1(t_uni_dist(rand_engine)); // random real     value [   -1,    1) - for testing asin,acos
+            Real          a2(t_uni_dist(rand_engine)); // random real     value [-1000, 1000) - for testing atan
 
-            assert            (c1                                 == CircVal<Type>((double)c1)         );
+            assert            ((c1                                == CircVal<Type, Real>((Real)c1))          );
 
             AssertCircAlmostEq(+c1                                  , c1                               ); // +c         = c
             AssertCircAlmostEq(-(-c1)                               , c1                               ); // -(-c)      = c
@@ -276,44 +454,45 @@ class CircValTester
             AssertCircAlmostEq(ZeroVal - c1                         , -c1                              ); // z-c        = -c
             AssertCircAlmostEq(c1      - c2                         , -(c2 - c1)                       ); // c1-c2      = -(c2-c1)
 
-            AssertCircAlmostEq(c1 * 0.                              , ZeroVal                          ); // c*0        = 0
-            AssertCircAlmostEq(c1 * 1.                              , c1                               ); // c*1        = c
-            AssertCircAlmostEq(c1 / 1.                              , c1                               ); // c/1        = c
+            AssertCircAlmostEq(c1 * Real(0)                         , ZeroVal                          ); // c*0        = 0
+            AssertCircAlmostEq(c1 * Real(1)                         , c1                               ); // c*1        = c
+            AssertCircAlmostEq(c1 / Real(1)                         , c1                               ); // c/1        = c
 
-            AssertCircAlmostEq((c1 * (1./(r+1.))) / (1./(r+1.))     , c1                               ); // (c*r)/r    = c, 0<r<=1
-            AssertCircAlmostEq((c1 / (    r+1.) ) * (    r+1. )     , c1                               ); // (c/r)*r    = c,   r>=1
+            AssertCircAlmostEq((c1 * (1/(r+1))) / (1/(r+1))         , c1                               ); // (c*r)/r    = c, 0<r<=1
+            AssertCircAlmostEq((c1 / (  r+1) ) * (  r+1 )           , c1                               ); // (c/r)*r    = c,   r>=1
 
             // --------------------------------------------------------
             AssertCircAlmostEq(~(~c1)                               , c1                               ); // opposite(opposite(c) = c
-            AssertCircAlmostEq(c1 - (~c1)                           , ToC<Type>(Type::R/2.)            ); // c - ~c               = r/2+z
+            AssertCircAlmostEq(c1 - (~c1)                           , ToC<Type, Real>(Type::R/2.)            ); // c - ~c               = r/2+z
 
             // --------------------------------------------------------
-            AssertAlmostEq    (sin(ToR(CircVal<SignedRadRange>(c1))),  sin(c1)                         ); // member func sin
-            AssertAlmostEq    (cos(ToR(CircVal<SignedRadRange>(c1))),  cos(c1)                         ); // member func cos
-            AssertAlmostEq    (tan(ToR(CircVal<SignedRadRange>(c1))),  tan(c1)                         ); // member func tan
+            AssertAlmostEq    (sin(ToR(CircVal<SignedRadRange, Real>(c1))),  sin(c1)                         ); // member func sin
+            AssertAlmostEq    (cos(ToR(CircVal<SignedRadRange, Real>(c1))),  cos(c1)                         ); // member func cos
+            AssertAlmostEq    (tan(ToR(CircVal<SignedRadRange, Real>(c1))),  tan(c1)                         ); // member func tan
 
             AssertAlmostEq    (sin(-c1)                             , -sin(c1)                         ); // sin(-c)    = -sin(c)
             AssertAlmostEq    (cos(-c1)                             ,  cos(c1)                         ); // cos(-c)    =  cos(c)
-            AssertAlmostEq    (tan(-c1)                             , -tan(c1)                         ); // tan(-c1)   = -tan(c) the error may be large
+            if (std::abs(tan(c1)) < (bFloat ? 1e2 : 1e5))                                                   // near the poles, the rounding error of -c1 is amplified by 1/cos^2 - beyond kMaxUlps
+                AssertAlmostEq(tan(-c1)                             , -tan(c1)                         ); // tan(-c1)   = -tan(c) the error may be large
 
-            AssertAlmostEq    (sin(c1+ToC<Type>(Type::R/4.))        ,  cos(c1)                         ); // sin(c+r/4) =  cos(c)
-            AssertAlmostEq    (cos(c1+ToC<Type>(Type::R/4.))        , -sin(c1)                         ); // cos(c+r/4) = -sin(c)
-            AssertAlmostEq    (sin(c1+ToC<Type>(Type::R/2.))        , -sin(c1)                         ); // sin(c+r/2) = -sin(c)
-            AssertAlmostEq    (cos(c1+ToC<Type>(Type::R/2.))        , -cos(c1)                         ); // cos(c+r/2) = -cos(c)
+            AssertAlmostEq    (sin(c1+ToC<Type, Real>(Type::R/4.))        ,  cos(c1)                         ); // sin(c+r/4) =  cos(c)
+            AssertAlmostEq    (cos(c1+ToC<Type, Real>(Type::R/4.))        , -sin(c1)                         ); // cos(c+r/4) = -sin(c)
+            AssertAlmostEq    (sin(c1+ToC<Type, Real>(Type::R/2.))        , -sin(c1)                         ); // sin(c+r/2) = -sin(c)
+            AssertAlmostEq    (cos(c1+ToC<Type, Real>(Type::R/2.))        , -cos(c1)                         ); // cos(c+r/2) = -cos(c)
 
             AssertAlmostEq    (Sqr(sin(c1))+Sqr(cos(c1))            , 1.                               ); // sin(x)^2+cos(x)^2 = 1
 
             AssertAlmostEq    (sin(c1)/cos(c1)                      , tan(c1)                          ); // sin(x)/cos(x) = tan(x)
 
             // --------------------------------------------------------
-            AssertCircAlmostEq(asin<Type>(a1)                       , CircVal<SignedRadRange>(asin(a1))); // member func asin
-            AssertCircAlmostEq(acos<Type>(a1)                       , CircVal<SignedRadRange>(acos(a1))); // member func acos
-            AssertCircAlmostEq(atan<Type>(a2)                       , CircVal<SignedRadRange>(atan(a2))); // member func atan
+            AssertCircAlmostEq(asin<Type, Real>(a1)                       , CircVal<SignedRadRange, Real>(asin(a1))); // member func asin
+            AssertCircAlmostEq(acos<Type, Real>(a1)                       , CircVal<SignedRadRange, Real>(acos(a1))); // member func acos
+            AssertCircAlmostEq(atan<Type, Real>(a2)                       , CircVal<SignedRadRange, Real>(atan(a2))); // member func atan
 
-            AssertCircAlmostEq(asin<Type>(a1) + asin<Type>(-a1)     , ZeroVal                          ); // asin(r)+asin(-r) = z
-            AssertCircAlmostEq(acos<Type>(a1) + acos<Type>(-a1)     , ToC<Type>(Type::R / 2.)          ); // acos(r)+acos(-r) = r/2+z
-            AssertCircAlmostEq(asin<Type>(a1) + acos<Type>( a1)     , ToC<Type>(Type::R / 4.)          ); // asin(r)+acos( r) = r/4+z
-            AssertCircAlmostEq(atan<Type>(a2) + atan<Type>(-a2)     , ZeroVal                          ); // atan(r)+atan(-r) = z
+            AssertCircAlmostEq(asin<Type, Real>(a1) + asin<Type, Real>(-a1)     , ZeroVal                          ); // asin(r)+asin(-r) = z
+            AssertCircAlmostEq(acos<Type, Real>(a1) + acos<Type, Real>(-a1)     , ToC<Type, Real>(Type::R / 2.)          ); // acos(r)+acos(-r) = r/2+z
+            AssertCircAlmostEq(asin<Type, Real>(a1) + acos<Type, Real>( a1)     , ToC<Type, Real>(Type::R / 4.)          ); // asin(r)+acos( r) = r/4+z
+            AssertCircAlmostEq(atan<Type, Real>(a2) + atan<Type, Real>(-a2)     , ZeroVal                          ); // atan(r)+atan(-r) = z
 
             // --------------------------------------------------------
             assert            ((c1 >  c2)                         ==    (c2 <  c1)                     ); // c1> c2 <==>   c2< c1
@@ -326,15 +505,211 @@ class CircValTester
             assert            (!(c1>c2) || !(c2>c3) || (c1>c3)                                         ); // (c1>c2)&&(c2>c3) ==> c1>c3
 
             // --------------------------------------------------------
-            AssertCircAlmostEq(c1                                   , ToC<Type>(ToR( c1)       )       ); //  c1        = ToC(ToR( c1)
-            AssertCircAlmostEq(-c1                                  , ToC<Type>(ToR(-c1)       )       ); // -c1        = ToC(ToR(-c1)
-            AssertCircAlmostEq(c1 + c2                              , ToC<Type>(ToR(c1)+ToR(c2))       ); // c1+c2      = ToC(ToR(c1)+ToR(c2))
-            AssertCircAlmostEq(c1 - c2                              , ToC<Type>(ToR(c1)-ToR(c2))       ); // c1-c2      = ToC(ToR(c1)-ToR(c2))
-            AssertCircAlmostEq(c1 * r                               , ToC<Type>(ToR(c1) * r    )       ); // c1*r       = ToC(ToR(c1)*r      )
-            AssertCircAlmostEq(c1 / r                               , ToC<Type>(ToR(c1) / r    )       ); // c1/r       = ToC(ToR(c1)/r      )
+            AssertCircAlmostEq(c1                                   , ToC<Type, Real>(ToR( c1)       )       ); //  c1        = ToC(ToR( c1)
+            AssertCircAlmostEq(-c1                                  , ToC<Type, Real>(ToR(-c1)       )       ); // -c1        = ToC(ToR(-c1)
+            AssertCircAlmostEq(c1 + c2                              , ToC<Type, Real>(ToR(c1)+ToR(c2))       ); // c1+c2      = ToC(ToR(c1)+ToR(c2))
+            AssertCircAlmostEq(c1 - c2                              , ToC<Type, Real>(ToR(c1)-ToR(c2))       ); // c1-c2      = ToC(ToR(c1)-ToR(c2))
+            AssertCircAlmostEq(c1 * r                               , ToC<Type, Real>(ToR(c1) * r    )       ); // c1*r       = ToC(ToR(c1)*r      )
+            AssertCircAlmostEq(c1 / r                               , ToC<Type, Real>(ToR(c1) / r    )       ); // c1/r       = ToC(ToR(c1)/r      )
 
             // --------------------------------------------------------
         }
+
+        TestWrap   ();
+        TestWrapN  ();
+        TestConvert();
+        TestSinCos ();
+    }
+
+    // sincos vs. sin,cos and vs. the exact values; sincosN vs. sincos
+    inline static void TestSinCos()
+    {
+        constexpr bool   bRad = std::equal_to<double>{}(Type::R, 2 * std::numbers::pi);
+        constexpr double Q    = Type::R / 4.;                                           // quarter turn
+
+        std::default_random_engine             rand_engine;
+        std::uniform_real_distribution<double> c_uni_dist(Type::L, Type::H);
+
+        std::random_device rnd_device;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        std::vector<CircVal<Type, Real>> C;
+        for (int k = -4; k <= 4; ++k)
+        {
+            C.emplace_back(ToC<Type, Real>(Q * k));
+            C.emplace_back(ToC<Type, Real>(Q * k + Q / 2.));
+        }
+        C.emplace_back(CircVal<Type, Real>::GetL());
+        C.emplace_back(std::nextafter(CircVal<Type, Real>::GetH(), CircVal<Type, Real>::GetL()));
+
+        for (unsigned i = 10000; i--;)
+            C.emplace_back(c_uni_dist(rand_engine));
+
+        std::vector<Real> S(C.size()), Co(C.size());
+        sincosN<Type, Real>(C, S, Co);
+
+        for (size_t i = 0; i < C.size(); ++i)
+        {
+            Real s, co;
+            sincos(C[i], s, co);
+            assert(std::equal_to<Real>{}(s, S[i]) && std::equal_to<Real>{}(co, Co[i]));    // sincosN is identical to sincos
+
+            assert(std::abs(s  - sin(C[i])) <= (bFloat ? 1e-6 : 4e-15));                   // vs. sin,cos (their conversion to radians is rounded)
+            assert(std::abs(co - cos(C[i])) <= (bFloat ? 1e-6 : 4e-15));
+
+            const double v = double(Real(C[i])) - double(CircVal<Type, Real>::GetZ());     // the angle, in the range's unit
+
+            if constexpr (!bRad)                                                            // multiples of a quarter turn are exact
+                if (std::equal_to<double>{}(std::nearbyint(v / Q) * Q, v))
+                    assert(std::equal_to<Real>{}(std::abs(s) + std::abs(co), Real(1)) && (std::equal_to<Real>{}(s, Real(0)) || std::equal_to<Real>{}(co, Real(0))));
+
+            // max error: 2 ULP (degrees, radians), 2.5 ULP (other ranges) - vs. an exact reduction and sin/cos in long double
+            if constexpr (!bFloat && std::numeric_limits<long double>::digits > std::numeric_limits<double>::digits)
+            {
+                const long double Pi = 3.141592653589793238462643383279502884L;
+                long double es, ec;
+                if constexpr (bRad)
+                {
+                    es = std::sin((long double)v);
+                    ec = std::cos((long double)v);
+                }
+                else
+                {
+                    const long double n  = std::nearbyint((long double)v / Q);
+                    const long double x  = ((long double)v - n * Q) * (Pi / 2) / Q;
+                    const long double s0 = std::sin(x), c0 = std::cos(x);
+                    const int         k  = int(n) & 3;
+                    es = k == 0 ? s0 : k == 1 ?  c0 : k == 2 ? -s0 : -c0;
+                    ec = k == 0 ? c0 : k == 1 ? -s0 : k == 2 ? -c0 :  s0;
+                }
+
+                auto Ulps = [](double f, long double e)
+                {
+                    const double a = std::abs(double(e));
+                    return std::abs(f - e) / (std::nextafter(a, 2.) - a);
+                };
+                constexpr double MaxUlps = bRad || std::equal_to<double>{}(Type::R, 360.) ? 2. : 2.5;
+                assert(Ulps(s, es) <= MaxUlps && Ulps(co, ec) <= MaxUlps);
+            }
+        }
+    }
+
+    // the specialized Wrap paths must agree with the general Mod path, and return values in the range
+    inline static void TestWrap()
+    {
+        static_assert(!std::is_same_v<Type, SignedDegRange  > || (Type::IsStdRange && !Type::IsPow2R));
+        static_assert(!std::is_same_v<Type, UnsignedRadRange> || (Type::IsStdRange && !Type::IsPow2R));
+        static_assert(!std::is_same_v<Type, TestRange0      > || (!Type::IsStdRange && !Type::IsPow2R));
+        static_assert(!std::is_same_v<Type, TestRange4      > || (!Type::IsStdRange &&  Type::IsPow2R));
+
+        std::default_random_engine             rand_engine;
+        std::uniform_real_distribution<double> n_uni_dist(Type::L - Type::R*2., Type::H + Type::R*2.); // near range
+        std::uniform_real_distribution<double> f_uni_dist(-1e6                , 1e6                 ); // far from range
+
+        std::random_device rnd_device;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        const     Real L   = CircVal<Type, Real>::GetL(), H = CircVal<Type, Real>::GetH(), R = CircVal<Type, Real>::GetR(), C = Real(Type::C); // the range, in Real
+        constexpr Real Max = std::numeric_limits<Real>::max();
+
+        std::vector<Real> In = { L, H, C, L - R, H + R, C + R*Real(1.5), C - R*Real(1.5),
+                                 std::nextafter(L, -Max), std::nextafter(H, -Max), std::nextafter(H, Max),
+                                 L - Real(1e-16), H - Real(1e-16), H + Real(1e-16), Real(-1e-16), Real(1e-16), Real(0) };
+
+        for (unsigned i = 10000; i--;)
+        {
+            In.emplace_back(n_uni_dist(rand_engine));
+            In.emplace_back(f_uni_dist(rand_engine));
+        }
+
+        for (const Real r : In)
+        {
+            const Real w = CircVal<Type, Real>::Wrap(r);
+            assert((CircVal<Type, Real>::IsInRange(w)));
+            assert((std::abs(CircVal<Type, Real>::Sdist(w, WrapMod(r))) <= (std::abs(r) + R) * (bFloat ? 1e-6 : 1e-15))); // both paths round r-q*R
+
+            if (Type::IsPow2R)
+                assert(std::equal_to<Real>{}(w, WrapMod(r))); // exact scaling
+            if (CircVal<Type, Real>::IsInRange(r))
+                assert(std::equal_to<Real>{}(w, r         )); // values in the range are returned as is
+        }
+    }
+
+    // reference for TestWrap: the general (Mod) path of Wrap
+    inline static Real WrapMod(Real r)
+    {
+        const Real L = CircVal<Type, Real>::GetL(), H = CircVal<Type, Real>::GetH(), R = CircVal<Type, Real>::GetR();
+
+        if (r >= L && r <  H  ) return r  ;
+        if (r >= H && r <  H+R) return r-R;
+        if (r <  L && r >= L-R) return r+R < H ? r+R : L;
+
+        return Mod(r - L, R) + L;
+    }
+
+    // conversion to another type and back
+    inline static void TestConvert()
+    {
+        CircVal<Type, Real> ZeroVal = Type::Z;
+
+        assert(std::equal_to<double>{}(CircVal<UnsignedDegRange>(ZeroVal), 0.)); // Z is converted to Z
+        assert(std::equal_to<double>{}(CircVal<SignedDegRange  >(ZeroVal), 0.));
+
+        std::default_random_engine             rand_engine;
+        std::uniform_real_distribution<double> c_uni_dist(Type::L, Type::H);
+
+        std::random_device rnd_device;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        for (unsigned i = 10000; i--;)
+        {
+            const CircVal<Type, Real> c(c_uni_dist(rand_engine));
+
+            AssertCircAlmostEq(CircVal<Type, Real>(CircVal<UnsignedDegRange>(c)), c);
+            AssertCircAlmostEq(CircVal<Type, Real>(CircVal<SignedRadRange  >(c)), c);
+            AssertCircAlmostEq(CircVal<Type, Real>(CircVal<TestRange4      >(c)), c);
+
+            const CircVal<TestRange1> c1(c);                                                                         // Z == L: no shift
+            AssertCircAlmostEq(CircVal<Type, Real>(c1), CircVal<Type, Real>::Wrap(c1.Pdist(c1.GetZ(), c1) * Type::R/TestRange1::R + Type::Z));
+
+            const CircVal<Type> d(c);                                                                                // to double (and back)
+            AssertCircAlmostEq(CircVal<Type, Real>(d), c);
+        }
+    }
+
+    // WrapN must be identical to Wrap, for all ranges of input values
+    inline static void TestWrapN()
+    {
+        std::default_random_engine             rand_engine;
+        std::uniform_real_distribution<double> n_uni_dist(Type::L - Type::R*2., Type::H + Type::R*2.); // near range
+        std::uniform_real_distribution<double> f_uni_dist(-1e6                , 1e6                 ); // far from range
+
+        std::random_device rnd_device;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        const     Real L   = CircVal<Type, Real>::GetL(), H = CircVal<Type, Real>::GetH(), R = CircVal<Type, Real>::GetR(), Z = CircVal<Type, Real>::GetZ(); // the range, in Real
+        constexpr Real Max = std::numeric_limits<Real>::max();
+
+        std::vector<Real> In = { L, H, Z, L - R, H + R, // boundaries
+                                 std::nextafter(L, -Max), std::nextafter(H, -Max),
+                                 std::nextafter(H + R, -Max), std::nextafter(L - R, -Max),
+                                 L - Real(1e-16), L + Real(1e-16), H - Real(1e-16), Real(-1e-16), Real(1e-16), Real(0),
+                                 L - R*Real(3) - Real(1e-16), H + R*Real(7) - Real(1e-15), Real(106.81415022205296), Real(-106.81415022205296) };
+
+        for (unsigned i = 10000; i--;)
+        {
+            In.emplace_back(n_uni_dist(rand_engine));
+            In.emplace_back(f_uni_dist(rand_engine));
+        }
+
+        std::vector<Real> Out(In.size());
+        CircVal<Type, Real>::WrapN(In, Out);
+
+        for (size_t i = 0; i < In.size(); ++i)
+            assert((std::equal_to<Real>{}(Out[i], CircVal<Type, Real>::Wrap(In[i]))));
+
+        CircVal<Type, Real>::WrapN(In);                                             // in-place
+        assert(std::equal(In.begin(), In.end(), Out.begin(), std::equal_to<Real>{}));
     }
 
 public:
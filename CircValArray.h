@@ -0,0 +1,183 @@
+// ==========================================================================
+// Copyright (C) 2026 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+// classes defined here:
+// CircValArray       - contiguous array of circular-values, with whole-array circular arithmetic
+// CircValArrayTester - tester for CircValArray class
+// ==========================================================================
+
+#pragma once
+
+#include <vector>
+#include <span>            // std::span
+#include <algorithm>       // std::min
+#include <assert.h>
+
+#include "CircVal.h"       // CircVal
+#include "CircHelper.h"    // AlignedAllocator
+
+// ==========================================================================
+// contiguous, 64-byte aligned array of circular values
+// all elements are always wrapped to [Type::L, Type::H)
+// the whole-array operators work in-place (no temporaries), and return the same values as the element-wise CircVal operators
+// View() exposes the elements as std::span<const CircVal<Type>>, which can be passed to CircAverage, CircMedian etc. without copying
+// Type should be defined using the CircValType template
+template <typename Type>
+class CircValArray
+{
+    static_assert(sizeof(CircVal<Type>) == sizeof(double) && std::is_standard_layout_v<CircVal<Type>>,
+                  "CircValArray: CircVal is expected to wrap a single double");
+
+    static constexpr size_t BlockSize = 1024; // elements are first computed, then wrapped - block by block (while in L1 cache)
+
+    std::vector<CircVal<Type>, AlignedAllocator<CircVal<Type>>> m_Vals;
+
+    // raw access to the elements' values. only wrapped values may be stored
+          double* Raw()       { return reinterpret_cast<      double*>(m_Vals.data()); }
+    const double* Raw() const { return reinterpret_cast<const double*>(m_Vals.data()); }
+
+    // m_Vals[i] = Wrap(f(m_Vals[i], i)) for all i
+    template <typename F>
+    void Apply(F f)
+    {
+        double* p = Raw();
+        for (size_t b = 0; b < m_Vals.size(); b += BlockSize)
+        {
+            const size_t e = std::min(b + BlockSize, m_Vals.size());
+            for (size_t i = b; i < e; ++i)
+                p[i] = f(p[i], i);
+
+            CircVal<Type>::WrapN(p + b, p + b, e - b);
+        }
+    }
+
+public:
+    // ---------------------------------------------
+    CircValArray()
+    {
+    }
+
+    // construction of n zero-values (Type::Z)
+    explicit CircValArray(size_t n) : m_Vals(n)
+    {
+    }
+
+    // construction based on floating-point values
+    // floating-point values are wrapped into the range
+    explicit CircValArray(std::span<const double> r) : m_Vals(r.size())
+    {
+        CircVal<Type>::WrapN(r.data(), Raw(), r.size());
+    }
+
+    // construction based on circular values of the same type
+    explicit CircValArray(std::span<const CircVal<Type>> c) : m_Vals(c.begin(), c.end())
+    {
+    }
+
+    // ---------------------------------------------
+    size_t               size () const                   { return m_Vals.size();  }
+    bool                 empty() const                   { return m_Vals.empty(); }
+    void                 resize(size_t n)                { m_Vals.resize(n);      } // new elements are Type::Z
+
+          CircVal<Type>& operator[](size_t i)            { return m_Vals[i];      }
+    const CircVal<Type>& operator[](size_t i) const      { return m_Vals[i];      }
+
+          CircVal<Type>* data ()                         { return m_Vals.data();  }
+    const CircVal<Type>* data () const                   { return m_Vals.data();  }
+          CircVal<Type>* begin()                         { return m_Vals.data();  }
+    const CircVal<Type>* begin() const                   { return m_Vals.data();  }
+          CircVal<Type>* end  ()                         { return m_Vals.data() + m_Vals.size(); }
+    const CircVal<Type>* end  () const                   { return m_Vals.data() + m_Vals.size(); }
+
+    // zero-copy view, e.g. CircAverage(a.View())
+    std::span<const CircVal<Type>> View() const          { return std::span<const CircVal<Type>>(m_Vals.data(), m_Vals.size()); }
+    operator std::span<const CircVal<Type>>() const      { return View(); }
+
+    // ---------------------------------------------
+    // element-wise operators. the arrays must be of the same size
+    CircValArray& operator+=(const CircValArray& a) { assert(a.size() == size()); const double* q = a.Raw(); Apply([q](double v, size_t i) { return v + q[i] - Type::Z; }); return *this; }
+    CircValArray& operator-=(const CircValArray& a) { assert(a.size() == size()); const double* q = a.Raw(); Apply([q](double v, size_t i) { return v - q[i] + Type::Z; }); return *this; }
+
+    // operators with a single value, applied to all elements
+    CircValArray& operator+=(const CircVal<Type>& c) { const double q = c; Apply([q](double v, size_t) { return v + q           - Type::Z; }); return *this; }
+    CircValArray& operator-=(const CircVal<Type>& c) { const double q = c; Apply([q](double v, size_t) { return v - q           + Type::Z; }); return *this; }
+    CircValArray& operator*=(const double&        r) {                     Apply([r](double v, size_t) { return (v - Type::Z) * r + Type::Z; }); return *this; }
+    CircValArray& operator/=(const double&        r) {                     Apply([r](double v, size_t) { return (v - Type::Z) / r + Type::Z; }); return *this; }
+
+    // negative circular values (-c for each element)
+    CircValArray& Negate()
+    {
+        Apply([](double v, size_t)
+        {
+            double d = v - Type::Z;                // Sdist(Type::Z, v)
+            d = d <  -Type::R_2 ? d + Type::R :
+                d >=  Type::R_2 ? d - Type::R : d;
+            return Type::Z - d;
+        });
+        return *this;
+    }
+
+    // opposite circular values (~c for each element)
+    CircValArray& Opposite()
+    {
+        Apply([](double v, size_t) { return v + Type::R_2; });
+        return *this;
+    }
+};
+
+// ==========================================================================
+// tester for CircValArray class
+template <typename Type>
+class CircValArrayTester
+{
+    static bool IsEq(const CircValArray<Type>& a, const std::vector<CircVal<Type>>& v)
+    {
+        return std::equal(a.begin(), a.end(), v.begin(), v.end());
+    }
+
+public:
+    CircValArrayTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        std::default_random_engine             rand_engine                                    ;
+        std::uniform_real_distribution<double> c_uni_dist(Type::L - Type::R, Type::H + Type::R); // also values outside the range
+        std::uniform_real_distribution<double> r_uni_dist(0.               , 1000.            ); // for multiplication,division by real-value
+
+        std::random_device rnd_device;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        const size_t count = 3000; // not a multiple of the block size
+        std::vector<double> R1(count), R2(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            R1[i] = c_uni_dist(rand_engine);
+            R2[i] = c_uni_dist(rand_engine);
+        }
+
+        CircValArray<Type>         A1(R1), A2(R2);
+        std::vector<CircVal<Type>> V1(R1.begin(), R1.end()), V2(R2.begin(), R2.end());
+        assert(IsEq(A1, V1) && IsEq(A2, V2));
+
+        const CircVal<Type> c(c_uni_dist(rand_engine));
+        const double        r(r_uni_dist(rand_engine));
+
+        A1 += A2; for (size_t i = 0; i < count; ++i) V1[i] += V2[i]; assert(IsEq(A1, V1));
+        A1 -= A2; for (size_t i = 0; i < count; ++i) V1[i] -= V2[i]; assert(IsEq(A1, V1));
+        A1 += c ; for (auto& v : V1) v += c;                         assert(IsEq(A1, V1));
+        A1 -= c ; for (auto& v : V1) v -= c;                         assert(IsEq(A1, V1));
+        A1 *= r ; for (auto& v : V1) v *= r;                         assert(IsEq(A1, V1));
+        A1 /= r ; for (auto& v : V1) v /= r;                         assert(IsEq(A1, V1));
+        A1.Negate  (); for (auto& v : V1) v = -v;                    assert(IsEq(A1, V1));
+        A1.Opposite(); for (auto& v : V1) v = ~v;                    assert(IsEq(A1, V1));
+
+        for (const auto& v : A1)
+            assert(CircVal<Type>::IsInRange(v));
+
+        assert(reinterpret_cast<uintptr_t>(A1.data()) % 64 == 0);
+        assert(A1.View().data() == A1.data());                      // zero-copy view
+    }
+};
@@ -0,0 +1,301 @@
+// ==========================================================================
+// Copyright (C) 2026 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+// classes defined here:
+// CircValFixed       - circular-value stored as a binary angular measurement (BAM) word
+// CircValFixedTester - tester for CircValFixed class
+//
+// functions defined here:
+// ToCircVal          - convert BAM circular values to CircVal (batch)
+// ToCircValFixed     - convert CircVal circular values to BAM (batch)
+// CircAverage, CircAverage2, CircMedian - overloads for spans of BAM circular values
+// ==========================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>     // std::conditional_t
+#include <span>            // std::span
+#include <vector>
+#include <set>
+#include <assert.h>
+
+#include "CircVal.h"       // CircVal
+#include "CircHelper.h"    // RoundNearest
+#include "CircStat.h"      // CircAverage, CircAverage2, CircMedian, CircStatScratch
+
+// ==========================================================================
+// circular value stored as a Bits-bit binary angular measurement (BAM) word: Bits= 16 (uint16_t) or 32 (uint32_t)
+// the word w represents the circular value Type::Z + w * Type::R / 2^Bits. so the zero word is Type::Z, and the
+// arithmetic is exact integer arithmetic modulo 2^Bits: wrap-around is free (unsigned overflow), and there are no branches.
+// a value converted from a CircVal is rounded to the nearest multiple of Type::R / 2^Bits.
+// converts to and from the CircVal types; the statistics functions take spans of CircValFixed (see below)
+// Type should be defined using the CircValType template
+template <typename Type, unsigned Bits>
+class CircValFixed
+{
+    static_assert(Bits == 16 || Bits == 32, "CircValFixed: 16 or 32 bits expected");
+
+public:
+    using Word  = std::conditional_t<Bits == 16, uint16_t, uint32_t>; // BAM word
+    using SWord = std::conditional_t<Bits == 16, int16_t , int32_t >; // signed distance, in BAM units
+
+    static constexpr double Steps = double(uint64_t(1) << Bits); // 2^Bits: number of values
+    static constexpr double Step  = Type::R / Steps;             // resolution, in Type units
+    static constexpr Word   Half  = Word(Word(1) << (Bits - 1)); // Type::R/2, in BAM units
+
+private:
+    Word w; // BAM word
+
+    // BAM word of a circular value of any type: Pdist(Z2, c) scaled to [0, 2^Bits), rounded to the nearest
+    template<typename Type2>
+    inline static Word ToWord(const CircVal<Type2>& c)
+    {
+        constexpr double fScale = Steps / Type2::R;
+        return Word((uint64_t)RoundNearest(c.Pdist(c.GetZ(), c) * fScale)); // 2^Bits (rounded up) is wrapped to 0
+    }
+
+public:
+    // ---------------------------------------------
+    // construction from a BAM word
+    inline static CircValFixed FromBAM(Word w)
+    {
+        CircValFixed c;
+        c.w = w;
+        return c;
+    }
+
+    Word BAM() const { return w; }
+
+    // the length of shortest directed walk from c1 to c2, in BAM units: [-2^(Bits-1), 2^(Bits-1))
+    inline static SWord SdistBAM(const CircValFixed& c1, const CircValFixed& c2) { return SWord(Word(c2.w - c1.w)); }
+
+    // the length of the shortest increasing walk from c1 to c2, in BAM units: [0, 2^Bits)
+    inline static Word  PdistBAM(const CircValFixed& c1, const CircValFixed& c2) { return Word(c2.w - c1.w);         }
+
+    // as CircVal<Type>::Sdist, CircVal<Type>::Pdist: [-Type::R/2, Type::R/2), [0, Type::R)
+    inline static double Sdist(const CircValFixed& c1, const CircValFixed& c2) { return SdistBAM(c1, c2) * Step; }
+    inline static double Pdist(const CircValFixed& c1, const CircValFixed& c2) { return PdistBAM(c1, c2) * Step; }
+
+    // ---------------------------------------------
+    CircValFixed() : w(0) // Type::Z
+    {
+    }
+
+    // construction based on a floating-point value
+    // floating-point is wrapped into the range, and rounded to the resolution
+    explicit CircValFixed(double r) : w(ToWord(CircVal<Type>(r)))
+    {
+    }
+
+    // construction based on a circular value of any type
+    template<typename Type2>
+    CircValFixed(const CircVal<Type2>& c) : w(ToWord(c))
+    {
+    }
+
+    // ---------------------------------------------
+    // conversion to a circular value of any type
+    template<typename Type2>
+    operator CircVal<Type2>() const
+    {
+        constexpr double fScale = Type2::R / Steps;
+
+        const double v = w * fScale + Type2::Z;                         // [Z2, Z2+R2)
+        return CircVal<Type2>(v < Type2::H ? v : v - Type2::R);         // as CircVal's cross-type conversion
+    }
+
+    // convert circular-value c to real-value [L-Z,H-Z). Z is converted to 0
+    friend double ToR(const CircValFixed& c) { return ToR(CircVal<Type>(c)); }
+
+    // ---------------------------------------------
+    // exact: modulo 2^Bits
+    const CircValFixed  operator+ (                     ) const { return *this;                                     }
+    const CircValFixed  operator- (                     ) const { return FromBAM(Word(-w));                         } // return negative circular value
+    const CircValFixed  operator~ (                     ) const { return FromBAM(Word(w + Half));                   } // return opposite circular-value
+
+    const CircValFixed  operator+ (const CircValFixed& c) const { return FromBAM(Word(w + c.w));                    }
+    const CircValFixed  operator- (const CircValFixed& c) const { return FromBAM(Word(w - c.w));                    }
+    const CircValFixed  operator* (int                 k) const { return FromBAM(Word(uint32_t(w) * Word(k)));      } // integer multiple
+
+          CircValFixed& operator+=(const CircValFixed& c)       { w = Word(w + c.w);               return *this;    }
+          CircValFixed& operator-=(const CircValFixed& c)       { w = Word(w - c.w);               return *this;    }
+          CircValFixed& operator*=(int                 k)       { w = Word(uint32_t(w) * Word(k)); return *this;    }
+
+    // as the CircVal operators (the result is rounded to the resolution)
+    const CircValFixed  operator* (const double&       r) const { return CircValFixed(CircVal<Type>(*this) * r);    }
+    const CircValFixed  operator/ (const double&       r) const { return CircValFixed(CircVal<Type>(*this) / r);    }
+
+          bool          operator==(const CircValFixed& c) const { return w == c.w;                                  }
+          bool          operator!=(const CircValFixed& c) const { return w != c.w;                                  }
+};
+
+// ==========================================================================
+// convert n BAM circular values to CircVal. branch-free - the loop can be vectorized
+template <typename Type, unsigned Bits>
+void ToCircVal(std::span<const CircValFixed<Type, Bits>> In, std::span<CircVal<Type>> Out)
+{
+    assert(In.size() == Out.size());
+
+    for (size_t i = 0; i < In.size(); ++i)
+        Out[i] = In[i];
+}
+
+// convert n CircVal circular values to BAM (rounded to the resolution)
+template <typename Type, unsigned Bits>
+void ToCircValFixed(std::span<const CircVal<Type>> In, std::span<CircValFixed<Type, Bits>> Out)
+{
+    assert(In.size() == Out.size());
+
+    for (size_t i = 0; i < In.size(); ++i)
+        Out[i] = In[i];
+}
+
+// ==========================================================================
+// statistics of BAM circular values: the values are converted to CircVal<T> into Scratch.Values, and passed to the
+// CircVal overload. the results are CircVal<T> (an average is not necessarily a multiple of the resolution)
+// allocation-free, as the CircVal overloads, when the scratch and the result set are reused
+template <typename T, unsigned Bits>
+std::span<const CircVal<T>> ToCircVal(std::span<const CircValFixed<T, Bits>> A, CircStatScratch& Scratch)
+{
+    static_assert(sizeof(CircVal<T>) == sizeof(double), "CircValFixed: CircVal is expected to wrap a single double");
+
+    Scratch.Values.resize(A.size());
+    const std::span<CircVal<T>> V(reinterpret_cast<CircVal<T>*>(Scratch.Values.data()), A.size());
+    ToCircVal(A, V);
+    return V;
+}
+
+template<typename T, unsigned Bits, typename ResultSet>
+void CircAverage (std::span<const CircValFixed<T, Bits>> A, ResultSet& X, CircStatScratch& Scratch, CircSumMode Mode = CircSumMode::Fast)
+{
+    CircAverage<T>(ToCircVal(A, Scratch), X, Scratch, Mode);
+}
+
+template<typename T, unsigned Bits, typename ResultSet>
+void CircAverage2(std::span<const CircValFixed<T, Bits>> A, ResultSet& X, CircStatScratch& Scratch, CircSumMode Mode = CircSumMode::Fast)
+{
+    CircAverage2<T>(ToCircVal(A, Scratch), X, Scratch, Mode);
+}
+
+template<typename T, unsigned Bits, typename ResultSet>
+void CircMedian  (std::span<const CircValFixed<T, Bits>> A, ResultSet& X, CircStatScratch& Scratch)
+{
+    CircMedian<T>(ToCircVal(A, Scratch), X, Scratch);
+}
+
+template<typename T, unsigned Bits>
+std::set<CircVal<T>> CircAverage (std::span<const CircValFixed<T, Bits>> A, CircSumMode Mode = CircSumMode::Fast)
+{
+    std::set<CircVal<T>> X;
+    CircStatScratch      Scratch;
+    CircAverage(A, X, Scratch, Mode);
+    return X;
+}
+
+template<typename T, unsigned Bits>
+std::set<CircVal<T>> CircAverage2(std::span<const CircValFixed<T, Bits>> A, CircSumMode Mode = CircSumMode::Fast)
+{
+    std::set<CircVal<T>> X;
+    CircStatScratch      Scratch;
+    CircAverage2(A, X, Scratch, Mode);
+    return X;
+}
+
+template<typename T, unsigned Bits>
+std::set<CircVal<T>> CircMedian  (std::span<const CircValFixed<T, Bits>> A)
+{
+    std::set<CircVal<T>> X;
+    CircStatScratch      Scratch;
+    CircMedian(A, X, Scratch);
+    return X;
+}
+
+// ==========================================================================
+// tester for CircValFixed class
+template <typename Type, unsigned Bits>
+class CircValFixedTester
+{
+    using Fixed = CircValFixed<Type, Bits>;
+    using Word  = typename Fixed::Word;
+
+    // check if a circular value is within half a resolution step (+rounding) of a CircVal
+    inline static bool IsNear(const Fixed& f, const CircVal<Type>& c)
+    {
+        return std::abs(CircVal<Type>::Sdist(c, CircVal<Type>(f))) <= Fixed::Step * (0.5 + 1e-6);
+    }
+
+public:
+    CircValFixedTester()
+    {
+        static_assert(sizeof(Fixed) == Bits / 8);
+
+        const Fixed ZeroVal;
+        assert(std::equal_to<double>{}(CircVal<Type>(ZeroVal), Type::Z));
+        assert(Fixed(Type::Z) == ZeroVal);
+        assert((~ZeroVal).BAM() == Fixed::Half);
+        assert(-Fixed::FromBAM(1) == Fixed::FromBAM(Word(~Word(0))));         // wrap-around
+        assert(Fixed::FromBAM(Word(~Word(0))) + Fixed::FromBAM(1) == ZeroVal);
+
+        std::default_random_engine             rand_engine;
+        std::uniform_real_distribution<double> c_uni_dist(Type::L, Type::H);
+        std::uniform_int_distribution<Word>    w_uni_dist;
+        std::uniform_int_distribution<int>     k_uni_dist(-1000, 1000);
+
+        std::random_device rnd_device;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        for (unsigned i = 10000; i--;)
+        {
+            const Fixed         f1 = Fixed::FromBAM(w_uni_dist(rand_engine));
+            const Fixed         f2 = Fixed::FromBAM(w_uni_dist(rand_engine));
+            const int           k  = k_uni_dist(rand_engine);
+            const CircVal<Type> c1 = f1, c2 = f2;
+
+            // exact round trips
+            assert(Fixed(c1)                            == f1);
+            assert(Fixed(CircVal<UnsignedDegRange>(f1)) == f1);
+            assert(Fixed(CircVal<SignedRadRange  >(f1)) == f1);
+
+            // exact arithmetic, consistent with the CircVal operators
+            assert(IsNear(f1 + f2 , c1 + c2));
+            assert(IsNear(f1 - f2 , c1 - c2));
+            assert(IsNear(-f1     , -c1    ));
+            assert(IsNear(~f1     , ~c1    ));
+            assert(IsNear(f1 * k  , c1 * double(k)));
+            assert((f1 + f2) - f2 == f1);
+            assert(f1 * 3 == f1 + f1 + f1);
+
+            // distances
+            const double fSdistErr = std::abs(Fixed::Sdist(f1, f2) - CircVal<Type>::Sdist(c1, c2)); // up to R at +-R/2
+            const double fPdistErr = std::abs(Fixed::Pdist(f1, f2) - CircVal<Type>::Pdist(c1, c2)); // up to R at 0
+            assert(fSdistErr <= Fixed::Step || fSdistErr >= Type::R - Fixed::Step);
+            assert(fPdistErr <= Fixed::Step || fPdistErr >= Type::R - Fixed::Step);
+            assert(Fixed::PdistBAM(f1, f2) == Fixed::Half || Fixed::SdistBAM(f1, f2) == -Fixed::SdistBAM(f2, f1));
+            assert(f1 + Fixed::FromBAM(Fixed::PdistBAM(f1, f2)) == f2);
+
+            // conversion from CircVal: rounded to the nearest
+            const CircVal<Type> c(c_uni_dist(rand_engine));
+            assert(IsNear(Fixed(c), c));
+        }
+
+        // statistics: same as the statistics of the converted values
+        for (size_t count : {1, 2, 3, 10, 100, 1000})
+        {
+            std::vector<Fixed>         F(count);
+            std::vector<CircVal<Type>> C(count);
+            for (auto& f : F)
+                f = Fixed::FromBAM(w_uni_dist(rand_engine));
+
+            ToCircVal<Type, Bits>(F, C);
+
+            assert((CircAverage <Type, Bits>(F) == CircAverage (C)));
+            assert((CircAverage2<Type, Bits>(F) == CircAverage2(C)));
+            assert((CircMedian  <Type, Bits>(F) == CircMedian  (C)));
+
+            std::vector<Fixed> F2(count);
+            ToCircValFixed<Type, Bits>(C, F2);
+            assert(F2 == F);
+        }
+    }
+};
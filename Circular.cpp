@@ -5,26 +5,34 @@
 #include "stdafx.h"
 
 #include <chrono>
+#include <cstring>                  // strcmp
 #include <iostream>                 // cout
 #include <fstream>                  // ofstream
 #include <numbers>                  // std::numbers::pi
 #include <random>                   // random number generators 
-
-#include <ranges>                   // std::views::iota
-#include <execution>                // std::execution::par
-#include <syncstream>               // std::osyncstream
+#include <numeric>                  // std::iota
 
 #include "CircVal.h"                // CircVal, CircValTester
 #include "CircArc.h"                // CircArcLen, CircArc, CircArcTester
-#include "CircStat.h"               // CircAverage, WeightedCircAverage, CAvrgSampledCircSignal, CircMedian
+#include "CircValArray.h"           // CircValArray, CircValArrayTester
+#include "CircValFixed.h"           // CircValFixed, CircValFixedTester
+#include "CircStat.h"               // CircAverage, WeightedCircAverage, CAvrgSampledCircSignal, CircMedian, CircStatTester
+#include "CircSketch.h"             // CircAverageSketch, CircQuantileSketch, CircSketchTester
 #include "CircHelper.h"             // Sqr, Mod
 #include "TruncNormalDist.h"        // truncated_normal_distribution
 #include "WrappedNormalDist.h"      // wrapped_normal_distribution
 #include "WrappedTruncNormalDist.h" // wrapped_truncated_normal_distribution
+#include "PhiloxEngine.h"           // PhiloxEngine, PhiloxEngineTester
+#include "CircMonteCarlo.h"         // CircMonteCarlo, CircMonteCarloTester
 
 // ==========================================================================
-int _tmain(int argc, _TCHAR* argv[])
+// usage: Circular [--tests]
+//   --tests: run only the correctness tests (the testers) - used by ctest. default: tests and sample code
+// the benchmarks are in CircularBench.cpp
+int main(int argc, char* argv[])
 {
+    const bool bTestsOnly = argc > 1 && strcmp(argv[1], "--tests") == 0;
+
     auto Time0 = chrono::system_clock::now();
 
     // ------------------------------------------------------
@@ -80,6 +88,14 @@ int _tmain(int argc, _TCHAR* argv[])
         CircValTester<TestRange1      > test1;
         CircValTester<TestRange2      > test2;
         CircValTester<TestRange3      > test3;
+        CircValTester<TestRange4      > test4;
+
+        CircValTester<SignedDegRange  , float> testAf; // single-precision
+        CircValTester<UnsignedDegRange, float> testBf;
+        CircValTester<SignedRadRange  , float> testCf;
+        CircValTester<UnsignedRadRange, float> testDf;
+        CircValTester<TestRange0      , float> test0f;
+        CircValTester<TestRange4      , float> test4f;
     }
 
     // ------------------------------------------------------
@@ -96,6 +112,199 @@ int _tmain(int argc, _TCHAR* argv[])
         CircArcTester<TestRange3      > test3;
     }
 
+    // ------------------------------------------------------
+    // testing correctness of CircValArray class implementation
+    {
+        CircValArrayTester<SignedDegRange  > testA;
+        CircValArrayTester<UnsignedDegRange> testB;
+        CircValArrayTester<SignedRadRange  > testC;
+        CircValArrayTester<UnsignedRadRange> testD;
+
+        CircValArrayTester<TestRange0      > test0;
+        CircValArrayTester<TestRange1      > test1;
+        CircValArrayTester<TestRange2      > test2;
+        CircValArrayTester<TestRange3      > test3;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of CircValFixed class implementation
+    {
+        CircValFixedTester<SignedDegRange  , 16> testA16;
+        CircValFixedTester<SignedDegRange  , 32> testA32;
+        CircValFixedTester<UnsignedDegRange, 16> testB16;
+        CircValFixedTester<UnsignedRadRange, 32> testD32;
+        CircValFixedTester<TestRange2      , 16> test216;
+        CircValFixedTester<TestRange3      , 32> test332;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of circular statistics
+    {
+        CircStatTester<SignedDegRange  > testA;
+        CircStatTester<UnsignedDegRange> testB;
+        CircStatTester<SignedRadRange  > testC;
+        CircStatTester<UnsignedRadRange> testD;
+
+        CircStatTester<TestRange0      > test0;
+        CircStatTester<TestRange1      > test1;
+        CircStatTester<TestRange2      > test2;
+        CircStatTester<TestRange3      > test3;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of the mergeable sketches
+    {
+        CircSketchTester<SignedDegRange  > testA;
+        CircSketchTester<UnsignedDegRange> testB;
+        CircSketchTester<SignedRadRange  > testC;
+        CircSketchTester<UnsignedRadRange> testD;
+
+        CircSketchTester<TestRange0      > test0;
+        CircSketchTester<TestRange1      > test1;
+        CircSketchTester<TestRange2      > test2;
+        CircSketchTester<TestRange3      > test3;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of the counter-based random number engine
+    {
+        PhiloxEngineTester test;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of the Monte Carlo harness
+    {
+        CircMonteCarloTester<SignedDegRange  > testA;
+        CircMonteCarloTester<UnsignedRadRange> testD;
+        CircMonteCarloTester<TestRange1      > test1;
+    }
+
+    // ------------------------------------------------------
+    // testing the distributions: the mean of each (forced) sampling algorithm over a grid of normalized truncation-ranges,
+    // and the statistical equivalence of batch (generate) and scalar sampling. default-seeded engine - deterministic
+    {
+        std::default_random_engine rand_engine;
+
+        // P(NA <= x <= NB) and the truncated-normal mean
+        auto Mass = [](double fNA, double fNB) { return (erfc(fNA / sqrt(2.)) - erfc(fNB / sqrt(2.))) / 2.; };
+        auto Mean = [](double fNA, double fNB, double fMass) { return (exp(-Sqr(fNA) / 2.) - exp(-Sqr(fNB) / 2.)) / sqrt(2. * std::numbers::pi) / fMass; };
+
+        const size_t count = 50000;
+        vector<double> Out(count);
+
+        // truncated_normal_distribution: algorithms 0..4, skipping the ones impractical for the range
+        using tn_param_type = truncated_normal_distribution<double>::param_type;
+        for (const double fNA : { -3., -1., -0.5, 0., 0.5, 2., 4. })
+            for (const double fWidth : { 0.1, 1., 4. })
+            {
+                const double fNB   = fNA + fWidth;
+                const double fMass = Mass(fNA, fNB);
+
+                for (int nAlg = 0; nAlg <= 4; ++nAlg)
+                {
+                    if ((nAlg == 0 && fMass < 0.05) || (nAlg == 1 && fNA < 0.) || (nAlg == 2 && fNB > 0.))
+                        continue;
+
+                    tn_param_type Par(0., 1., fNA, fNB);
+                    Par._Alg = nAlg;                            // force the algorithm
+                    if (nAlg == 4)
+                        Par._InitStrips();
+
+                    truncated_normal_distribution<double> r_trn(Par);
+
+                    double fSum = 0.;
+                    for (size_t i = 0; i < count; ++i)
+                        fSum += r_trn(rand_engine);
+
+                    assert(abs(fSum / count - Mean(fNA, fNB, fMass)) < 0.02); // standard error < 1/sqrt(count)
+                }
+            }
+
+        // wrapped_truncated_normal_distribution: rejection algorithms 0..3, inverse-CDF (4), and inverse-CDF generate (5)
+        using wtn_param_type = wrapped_truncated_normal_distribution<double>::param_type;
+        for (const double fNA : { -3., -1., 0., 0.5, 2., 4., 8. })
+            for (const double fWidth : { 0.01, 0.1, 1., 4. })
+            {
+                const double fNB   = fNA + fWidth;
+                const double fMass = Mass(fNA, fNB);
+
+                for (int nAlg = 0; nAlg <= 5; ++nAlg)
+                {
+                    if ((nAlg == 0 && fMass < 0.05) || (nAlg == 1 && fNA < 0.) || (nAlg == 2 && fNB > 0.) || (nAlg == 3 && fWidth > 1. && fNA >= 2.))
+                        continue;
+
+                    wtn_param_type Par(0., 1., fNA, fNB, -180., 180., nAlg >= 4); // normalized; wrapping does not change the values
+                    if (nAlg < 4)
+                        Par._Alg = nAlg;                        // force the algorithm
+                    assert(Par.alg() == min(nAlg, 4));
+
+                    wrapped_truncated_normal_distribution<double> r_wtn(Par);
+                    if (nAlg == 5) r_wtn.generate(rand_engine, Out);
+                    else           for (auto& r : Out) r = r_wtn(rand_engine);
+
+                    double fSum = 0.;
+                    for (const double r : Out)
+                    {
+                        assert(r >= fNA && r <= fNB);
+                        fSum += r;
+                    }
+
+                    assert(abs(fSum / count - Mean(fNA, fNB, fMass)) < 0.02); // standard error < 1/sqrt(count)
+                }
+            }
+
+        // inverse-CDF sampling in the far tail: Phi(-37) > 1e-300 is within NormalQuantile's domain; Phi(-38) is not,
+        // so that range keeps the rejection algorithm
+        {
+            const wtn_param_type ParIn (0., 1., -37., -36.5, -180., 180., true);
+            const wtn_param_type ParOut(0., 1., -38., -37.5, -180., 180., true);
+            assert(ParIn.alg() == 4 && ParOut.alg() != 4);
+
+            wrapped_truncated_normal_distribution<double> r_wtn(ParIn);
+            r_wtn.generate(rand_engine, Out);
+
+            assert(all_of(Out.begin(), Out.end(), [](double r) { return r >= -37. && r <= -36.5; }));
+            assert(*max_element(Out.begin(), Out.end()) - *min_element(Out.begin(), Out.end()) > 0.01);
+        }
+
+        // wrapped_normal_distribution: generate vs. scalar sampling - mean, standard deviation, and fraction of wrapped values
+        // (|x| > 135: 0.27%)
+        wrapped_normal_distribution<double> r_wrp(0., 45., -180., 180.);
+
+        vector<double> Out1(20 * count), Out2(20 * count);
+        for (auto& r : Out1)
+            r = r_wrp(rand_engine);
+        r_wrp.generate(rand_engine, Out2);
+
+        auto Moments = [](const vector<double>& v) -> tuple<double, double, double>
+        {
+            double fSum = 0., fSumSqr = 0.; size_t nTail = 0;
+            for (const double r : v)
+            {
+                assert(r >= -180. && r < 180.);
+                fSum    +=     r ;
+                fSumSqr += Sqr(r);
+                nTail   += abs(r) > 135.;
+            }
+
+            const double fMean = fSum / v.size();
+            return { fMean, sqrt(fSumSqr / v.size() - Sqr(fMean)), (double)nTail / v.size() };
+        };
+
+        [[maybe_unused]] const auto [fMean1, fStdDev1, fTail1] = Moments(Out1);
+        [[maybe_unused]] const auto [fMean2, fStdDev2, fTail2] = Moments(Out2);
+
+        assert(abs(fMean1   - fMean2  ) < 0.3   ); // standard error: 45/sqrt(20*count)
+        assert(abs(fStdDev1 - fStdDev2) < 0.3   );
+        assert(abs(fTail1   - fTail2  ) < 0.0005);
+    }
+
+    if (bTestsOnly)
+    {
+        cout << "tests passed: " << chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - Time0).count() << " ms" << endl;
+        return 0;
+    }
+
     // ------------------------------------------------------
     // sample code: basic circular math operations
     {
@@ -164,43 +373,6 @@ int _tmain(int argc, _TCHAR* argv[])
         double d = r_wrp_trn(rand_engine); // random value
     }
 
-    // ------------------------------------------------------
-    {
-        std::default_random_engine rand_engine;
-        std::random_device         rnd_device ;
-        rand_engine.seed(rnd_device()); // reseed engine
-        uniform_real_distribution<double> ud(0., 360.);
-
-        const size_t count = 100;
-        vector<CircVal<UnsignedDegRange>> Angles2(count);
-
-        auto Time0 = chrono::system_clock::now();
-        for (size_t i = 0; i < 100000; i++)
-        {
-            for (size_t j = 0; j < count; ++j)
-                Angles2[j] = ud(rand_engine);
-
-            auto y = CircAverage (Angles2);
-        }
-
-        auto Duration = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - Time0).count();
-        cout << Duration << endl;
-
-        Time0 = chrono::system_clock::now();
-        for (int i = 0; i < 100000; i++)
-        {
-            for (size_t j = 0; j < count; ++j)
-                Angles2[j] = ud(rand_engine);
-
-            auto z = CircAverage2(Angles2);
-        }
-
-        Duration = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - Time0).count();
-        cout << Duration << endl;
-
-        cout << "=================" << endl;
-    }
-
     // ------------------------------------------------------
     // code used to collect data for graphs that demonstrate average of circular values
     {
@@ -214,7 +386,7 @@ int _tmain(int argc, _TCHAR* argv[])
         {
             double fSum = 0;
             for (const auto& a : Angles2)
-                fSum += Sqr(__min(abs(x-a), 360.-abs(x-a)));
+                fSum += Sqr(min(abs(x-a), 360.-abs(x-a)));
 
             f0 << x << "\t" << fSum << endl;
         }
@@ -242,6 +414,36 @@ int _tmain(int argc, _TCHAR* argv[])
         auto Medn  = CircMedian         (angles1);
         auto Avrg1 = CircAverage        (angles1);
         auto Avrg2 = WeightedCircAverage(angles2);
+
+        // whole-array arithmetic, and statistics over a zero-copy view
+        CircValArray<UnsignedDegRange> angles3(angles1);
+        angles3 += CircVal<UnsignedDegRange>(90.);
+        angles3 *= 0.5;
+
+        auto Avrg3 = CircAverage(angles3.View());
+    }
+
+    // ------------------------------------------------------
+    // sample code: average set of a dynamic collection (stream) of circular values
+    {
+        CircAverageAccumulator<UnsignedDegRange> Acc;
+        Acc.Add(CircVal<UnsignedDegRange>(350.));
+        Acc.Add(CircVal<UnsignedDegRange>( 10.));
+        Acc.Add(CircVal<UnsignedDegRange>( 30.));
+        Acc.Remove(CircVal<UnsignedDegRange>(30.));
+
+        auto Avrg = Acc.GetAvrg(); // {0}
+    }
+
+    // ------------------------------------------------------
+    // sample code: rolling average and median of the last 3 values
+    {
+        CircSlidingWindow<UnsignedDegRange> W(3);
+        for (double a : {10., 20., 350., 340., 0.})
+            W.Push(CircVal<UnsignedDegRange>(a));
+
+        auto Avrg = W.GetAvrg  (); // average of {350, 340, 0}
+        auto Medn = W.GetMedian(); // median  of {350, 340, 0}
     }
 
     // ------------------------------------------------------
@@ -258,68 +460,47 @@ int _tmain(int argc, _TCHAR* argv[])
 
     // ------------------------------------------------------
     // code used to collect data for RMS error of average estimation based on noisy measurements
+    // for each value of standard-deviation (1..100): 50000 trials of 1000 noisy observations around a random true value
     {
-        std::default_random_engine rand_engine;
-        std::random_device         rnd_device ;
-        rand_engine.seed(rnd_device()); // reseed engine
+        std::random_device rnd_device;
+        const uint64_t     nSeed = (uint64_t(rnd_device()) << 32) | rnd_device(); // written to log1.json - to reproduce a run
 
-        ofstream f1("log1.txt");
+        typedef CircMonteCarlo<UnsignedDegRange>::Samples Samples;
 
-        auto numbers = std::views::iota(1, 101); // for each value of standard-deviation: 1..100
-        std::for_each(std::execution::par, numbers.begin(), numbers.end(), [&rand_engine, &f1](int nStdDev) 
+        auto Dist = [](double fStdDev, PhiloxEngine& rand_engine, Samples& vInput)
         {
-            std::osyncstream(std::cout) << "StdDev: " << nStdDev << endl;
-
             uniform_real_distribution<double> ud(0., 360.);
 
-            double fSumSqrErr1 = 0.;
-            double fSumSqrErr2 = 0.;
-
-            const size_t nTrails  = 50000;                  // number of trails
-            const size_t nSamples =  1000;                  // number of observations per trail
-
-            vector<CircVal<UnsignedDegRange>> vInput(nSamples);
-
-            const double fAvrg = ud(rand_engine);           // our const parameter for this trail
-            wrapped_normal_distribution          <double> r_wnd1(fAvrg, nStdDev,                       0., 360.);
-         // wrapped_truncated_normal_distribution<double> r_wnd1(fAvrg, nStdDev, fAvrg-45., fAvrg+45., 0., 360.);
-
-            for (size_t t = 0; t < nTrails; ++t)
-            {
-                for (auto& Sample : vInput)
-                    Sample = r_wnd1(rand_engine);           // generate "noisy" observation
-
-                set<CircVal<UnsignedDegRange>> sAvrg1 = CircAverage(vInput);                   // avrg - method 1 (new method)
+            const double fAvrg = ud(rand_engine);                                   // our const parameter for this trail
+            wrapped_normal_distribution          <double> r_wnd1(fAvrg, fStdDev,                       0., 360.);
+         // wrapped_truncated_normal_distribution<double> r_wnd1(fAvrg, fStdDev, fAvrg-45., fAvrg+45., 0., 360.);
 
-                double fSigSin = 0.;
-                double fSigCos = 0.;
+            r_wnd1.generate(rand_engine, vInput.begin(), vInput.end());             // generate "noisy" observations
+            return CircVal<UnsignedDegRange>(fAvrg);
+        };
 
-                for (const auto& Sample : vInput)
-                {
-                    fSigSin += sin(Sample);
-                    fSigCos += cos(Sample);
-                }
+        vector<double> Grid(100);
+        iota(Grid.begin(), Grid.end(), 1.);
 
-                CircVal<UnsignedDegRange> Avrg2 = atan2<UnsignedDegRange>(fSigSin, fSigCos);   // avrg - method 2 (conventional method)
+        CircMonteCarlo<UnsignedDegRange> MC("wrapped_normal", Dist, "stddev", Grid);
 
-                const double fErr1 = CircVal<UnsignedDegRange>::Sdist(*sAvrg1.begin(), fAvrg); // error of estimate - method 1
-                const double fErr2 = CircVal<UnsignedDegRange>::Sdist(Avrg2          , fAvrg); // error of estimate - method 2
+        MC.AddEstimator("CircAverage", [](const Samples& vInput)                  // avrg - method 1 (new method)
+        {
+            return *CircAverage(vInput).begin();
+        });
 
-                fSumSqrErr1 += Sqr(fErr1);
-                fSumSqrErr2 += Sqr(fErr2);
-            }
+        MC.AddEstimator("atan2", [](const Samples& vInput)                        // avrg - method 2 (conventional method)
+        {
+            return CircMeanResultant(vInput).Mean;
+        });
 
-            const double fRMS1 = sqrt(fSumSqrErr1 / (nTrails-1));  // root mean square error - method 1
-            const double fRMS2 = sqrt(fSumSqrErr2 / (nTrails-1));  // root mean square error - method 2
+        MC.Run(50000, 1000, nSeed);
 
-            std::osyncstream(f1) << nStdDev << "\t" << fRMS1 << "\t" << fRMS2 << endl; // save RMS results to file
-        } );
+        ofstream f1("log1.csv" ); MC.WriteCSV (f1); // RMS results, sorted by standard-deviation
+        ofstream f2("log1.json"); MC.WriteJSON(f2); // RMS results, and run statistics (wall time, throughput)
+        cout << "Monte Carlo: " << MC.TotalTrials() << " trials, " << MC.WallTime() << " s, " << MC.Throughput() << " trials/s" << endl;
     }
 
-    // -----------------------------------
-    auto Duration = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - Time0).count();
-    cout << Duration << endl;
-
     // system ("pause");
 
     return 0;
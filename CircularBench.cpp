@@ -0,0 +1,747 @@
+// ==========================================================================
+// Copyright (C) 2026 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+// micro-benchmarks of the CircVal/CircStat hot paths and of the distributions
+//
+// usage: CircularBench [--filter=<regex>] [--max_n=<n>] [--min_time=<seconds>] [--format=console|csv|json] [--out=<file>] [--compare=<file>]
+//   --filter  : run only the benchmarks whose name matches the regex (default: all)
+//   --max_n   : largest problem size (default: 10^7)
+//   --min_time: minimal time of the timed loop of each (benchmark, n) (default: 0.05)
+//   --format  : report format (default: console). csv/json: one record per (benchmark, n) in a fixed order - diffable across commits
+//   --out     : report file (default: stdout). the progress is always written to stderr
+//   --compare : CSV report of a baseline run (e.g. a plain build). the report compares this run against it (console/csv)
+//
+// input distributions of the statistics benchmarks (also the PGO training workloads - see CircularPgo.cmake):
+//   (none)    : uniform over the range
+//   Clustered : uniform over [20,40] - many ties near the optimum
+//   Headings  : wrapped-normal around the wrap point of the range (180 degrees) - every sweep crosses the wrap
+// ==========================================================================
+
+#define MICROBENCH_COUNT_ALLOCATIONS
+#include "MicroBench.h"             // BenchState, BenchRegistry, DoNotOptimize
+
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "CircVal.h"                // CircVal
+#include "CircArc.h"                // CircArc
+#include "CircValFixed.h"           // CircValFixed
+#include "CircStat.h"               // CircAverage, CircAverage2, CircAverageLinear, WeightedCircAverage, CircMedian, CircMeanResultant
+#include "CircSketch.h"             // CircAverageSketch, CircQuantileSketch
+#include "TruncNormalDist.h"        // truncated_normal_distribution
+#include "WrappedNormalDist.h"      // wrapped_normal_distribution
+#include "WrappedTruncNormalDist.h" // wrapped_truncated_normal_distribution
+#include "PhiloxEngine.h"           // PhiloxEngine
+
+typedef SignedDegRange BenchType;
+
+// ==========================================================================
+// inputs - the same for every run (fixed seed, one stream per input)
+static vector<double> RandomReals(size_t n, double fMin, double fMax, uint64_t nStream)
+{
+    PhiloxEngine                      rand_engine(2026, nStream);
+    uniform_real_distribution<double> ud(fMin, fMax);
+
+    vector<double> R(n);
+    for (auto& r : R)
+        r = ud(rand_engine);
+    return R;
+}
+
+static vector<CircVal<BenchType>> RandomCircVals(size_t n, uint64_t nStream)
+{
+    const vector<double> R = RandomReals(n, BenchType::L, BenchType::H, nStream);
+    return vector<CircVal<BenchType>>(R.begin(), R.end());
+}
+
+// values clustered around 30 degrees: the statistics functions see many ties near the optimum
+static vector<CircVal<BenchType>> ClusteredCircVals(size_t n, uint64_t nStream)
+{
+    const vector<double> R = RandomReals(n, 20., 40., nStream);
+    return vector<CircVal<BenchType>>(R.begin(), R.end());
+}
+
+// values within 1e-9 degrees of 30 degrees: the sums of distances of the median candidates differ by ~1e-14
+static vector<CircVal<BenchType>> TightCircVals(size_t n, uint64_t nStream)
+{
+    const vector<double> R = RandomReals(n, 30. - 1e-9, 30. + 1e-9, nStream);
+    return vector<CircVal<BenchType>>(R.begin(), R.end());
+}
+
+// a single repeated value
+static vector<CircVal<BenchType>> ConstantCircVals(size_t n, uint64_t)
+{
+    return vector<CircVal<BenchType>>(n, CircVal<BenchType>(30.));
+}
+
+// unwrapped headings around the wrap point of the range: 180 + N(0, 20^2). about half of the values need wrapping
+static vector<double> NearWrapReals(size_t n, uint64_t nStream)
+{
+    PhiloxEngine                rand_engine(2026, nStream);
+    normal_distribution<double> nd(BenchType::H, 20.);
+
+    vector<double> R(n);
+    for (auto& r : R)
+        r = nd(rand_engine);
+    return R;
+}
+
+// wrapped-normal headings around the wrap point of the range
+static vector<CircVal<BenchType>> HeadingCircVals(size_t n, uint64_t nStream)
+{
+    PhiloxEngine                        rand_engine(2026, nStream);
+    wrapped_normal_distribution<double> wnd(BenchType::H, 20., BenchType::L, BenchType::H);
+
+    vector<CircVal<BenchType>> C(n);
+    for (auto& c : C)
+        c = wnd(rand_engine);
+    return C;
+}
+
+// ==========================================================================
+// CircVal
+static void BM_Wrap(BenchState& State)
+{
+    const vector<double> R = RandomReals(State.n(), -720., 720., 1);
+    vector<double>       Out(State.n());
+
+    for (auto _ : State)
+    {
+        for (size_t i = 0; i < R.size(); ++i)
+            Out[i] = CircVal<BenchType>::Wrap(R[i]);
+        DoNotOptimize(Out.data());
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_Wrap_NearWrap(BenchState& State)
+{
+    const vector<double> R = NearWrapReals(State.n(), 1);
+    vector<double>       Out(State.n());
+
+    for (auto _ : State)
+    {
+        for (size_t i = 0; i < R.size(); ++i)
+            Out[i] = CircVal<BenchType>::Wrap(R[i]);
+        DoNotOptimize(Out.data());
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_WrapN(BenchState& State)
+{
+    const vector<double> R = RandomReals(State.n(), -720., 720., 1);
+    vector<double>       Out(State.n());
+
+    for (auto _ : State)
+    {
+        CircVal<BenchType>::WrapN(R.data(), Out.data(), R.size());
+        DoNotOptimize(Out.data());
+    }
+
+    State.SetElements((double)State.n());
+}
+
+// single-precision: half the memory traffic (the SIMD kernels are double - the scalar loop is auto-vectorized)
+static void BM_WrapN_Float(BenchState& State)
+{
+    const vector<double> R = RandomReals(State.n(), -720., 720., 1);
+    const vector<float>  RF(R.begin(), R.end());
+    vector<float>        Out(State.n());
+
+    for (auto _ : State)
+    {
+        CircVal<BenchType, float>::WrapN(RF.data(), Out.data(), RF.size());
+        DoNotOptimize(Out.data());
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_Sdist(BenchState& State)
+{
+    const auto A = RandomCircVals(State.n(), 1), B = RandomCircVals(State.n(), 2);
+
+    for (auto _ : State)
+    {
+        double fSum = 0.;
+        for (size_t i = 0; i < A.size(); ++i)
+            fSum += CircVal<BenchType>::Sdist(A[i], B[i]);
+        DoNotOptimize(fSum);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_Sdist_Headings(BenchState& State)
+{
+    const auto A = HeadingCircVals(State.n(), 1), B = HeadingCircVals(State.n(), 2);
+
+    for (auto _ : State)
+    {
+        double fSum = 0.;
+        for (size_t i = 0; i < A.size(); ++i)
+            fSum += CircVal<BenchType>::Sdist(A[i], B[i]);
+        DoNotOptimize(fSum);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_Sdist_Float(BenchState& State)
+{
+    const auto A = RandomCircVals(State.n(), 1), B = RandomCircVals(State.n(), 2);
+    const vector<CircVal<BenchType, float>> FA(A.begin(), A.end()), FB(B.begin(), B.end());
+
+    for (auto _ : State)
+    {
+        float fSum = 0.f;
+        for (size_t i = 0; i < FA.size(); ++i)
+            fSum += CircVal<BenchType, float>::Sdist(FA[i], FB[i]);
+        DoNotOptimize(fSum);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+// 16-bit BAM: integer Sdist, 4x smaller than CircVal
+static void BM_Sdist_Fixed16(BenchState& State)
+{
+    const auto A = RandomCircVals(State.n(), 1), B = RandomCircVals(State.n(), 2);
+    const vector<CircValFixed<BenchType, 16>> FA(A.begin(), A.end()), FB(B.begin(), B.end());
+
+    for (auto _ : State)
+    {
+        int64_t nSum = 0;
+        for (size_t i = 0; i < FA.size(); ++i)
+            nSum += CircValFixed<BenchType, 16>::SdistBAM(FA[i], FB[i]);
+        DoNotOptimize(nSum);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_Pdist(BenchState& State)
+{
+    const auto A = RandomCircVals(State.n(), 1), B = RandomCircVals(State.n(), 2);
+
+    for (auto _ : State)
+    {
+        double fSum = 0.;
+        for (size_t i = 0; i < A.size(); ++i)
+            fSum += CircVal<BenchType>::Pdist(A[i], B[i]);
+        DoNotOptimize(fSum);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_Convert(BenchState& State) // SignedDegRange -> UnsignedRadRange
+{
+    const auto A = RandomCircVals(State.n(), 1);
+
+    for (auto _ : State)
+    {
+        double fSum = 0.;
+        for (const auto& a : A)
+            fSum += CircVal<UnsignedRadRange>(a);
+        DoNotOptimize(fSum);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_SinCos(BenchState& State)
+{
+    const auto A = RandomCircVals(State.n(), 1);
+
+    for (auto _ : State)
+    {
+        double fSum = 0.;
+        for (const auto& a : A)
+            fSum += sin(a) + cos(a);
+        DoNotOptimize(fSum);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_SinCos_Fused(BenchState& State)
+{
+    const auto A = RandomCircVals(State.n(), 1);
+
+    for (auto _ : State)
+    {
+        double fSum = 0.;
+        for (const auto& a : A)
+        {
+            double s, c;
+            sincos(a, s, c);
+            fSum += s + c;
+        }
+        DoNotOptimize(fSum);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_SinCosN(BenchState& State)
+{
+    const auto A = RandomCircVals(State.n(), 1);
+    vector<double> S(A.size()), C(A.size());
+
+    for (auto _ : State)
+    {
+        sincosN<BenchType, double>(A, S, C);
+        DoNotOptimize(S.data());
+        DoNotOptimize(C.data());
+    }
+
+    State.SetElements((double)State.n());
+}
+
+MICROBENCH(BM_Wrap          )->Range(10, 10000000);
+MICROBENCH(BM_Wrap_NearWrap )->Range(10, 10000000);
+MICROBENCH(BM_WrapN         )->Range(10, 10000000);
+MICROBENCH(BM_WrapN_Float   )->Range(10, 10000000);
+MICROBENCH(BM_Sdist         )->Range(10, 10000000);
+MICROBENCH(BM_Sdist_Headings)->Range(10, 10000000);
+MICROBENCH(BM_Sdist_Float   )->Range(10, 10000000);
+MICROBENCH(BM_Sdist_Fixed16 )->Range(10, 10000000);
+MICROBENCH(BM_Pdist         )->Range(10, 10000000);
+MICROBENCH(BM_Convert       )->Range(10, 10000000);
+MICROBENCH(BM_SinCos        )->Range(10, 10000000);
+MICROBENCH(BM_SinCos_Fused  )->Range(10, 10000000);
+MICROBENCH(BM_SinCosN       )->Range(10, 10000000);
+
+// ==========================================================================
+// CircStat
+// F(A, Scratch) for the input distribution Input(n, nStream). "_Scratch" variants: caller-owned scratch and result set - allocation-free
+template <typename F>
+static void BenchStat(BenchState& State, vector<CircVal<BenchType>> (*Input)(size_t, uint64_t), F f)
+{
+    const auto A = Input(State.n(), 1);
+    const span<const CircVal<BenchType>> S(A);
+    CircStatScratch                      Scratch;
+
+    for (auto _ : State)
+        f(S, Scratch);
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_CircAverage            (BenchState& State) { BenchStat(State, RandomCircVals   , [](auto S, auto&  ) { DoNotOptimize(CircAverage (S)); }); }
+static void BM_CircAverage_Clustered  (BenchState& State) { BenchStat(State, ClusteredCircVals, [](auto S, auto&  ) { DoNotOptimize(CircAverage (S)); }); }
+static void BM_CircAverage_Headings   (BenchState& State) { BenchStat(State, HeadingCircVals  , [](auto S, auto&  ) { DoNotOptimize(CircAverage (S)); }); }
+static void BM_CircAverage_Scratch    (BenchState& State) { BenchStat(State, RandomCircVals   , [](auto S, auto& Sc) { CircValSmallSet<BenchType> X; CircAverage (S, X, Sc); DoNotOptimize(X); }); }
+static void BM_CircAverage2           (BenchState& State) { BenchStat(State, RandomCircVals   , [](auto S, auto&  ) { DoNotOptimize(CircAverage2(S)); }); }
+static void BM_CircAverage2_Clustered (BenchState& State) { BenchStat(State, ClusteredCircVals, [](auto S, auto&  ) { DoNotOptimize(CircAverage2(S)); }); }
+static void BM_CircAverage2_Headings  (BenchState& State) { BenchStat(State, HeadingCircVals  , [](auto S, auto&  ) { DoNotOptimize(CircAverage2(S)); }); }
+static void BM_CircAverage2_Scratch   (BenchState& State) { BenchStat(State, RandomCircVals   , [](auto S, auto& Sc) { CircValSmallSet<BenchType> X; CircAverage2(S, X, Sc); DoNotOptimize(X); }); }
+static void BM_CircAverageLinear      (BenchState& State) { BenchStat(State, RandomCircVals   , [](auto S, auto&  ) { DoNotOptimize(CircAverageLinear(S)); }); }
+static void BM_CircMedian             (BenchState& State) { BenchStat(State, RandomCircVals   , [](auto S, auto&  ) { DoNotOptimize(CircMedian  (S)); }); }
+static void BM_CircMedian_Headings    (BenchState& State) { BenchStat(State, HeadingCircVals  , [](auto S, auto&  ) { DoNotOptimize(CircMedian  (S)); }); }
+static void BM_CircMedian_Tight       (BenchState& State) { BenchStat(State, TightCircVals    , [](auto S, auto&  ) { DoNotOptimize(CircMedian  (S)); }); }
+static void BM_CircMedian_Constant    (BenchState& State) { BenchStat(State, ConstantCircVals , [](auto S, auto&  ) { DoNotOptimize(CircMedian  (S)); }); }
+static void BM_CircMedian_Scratch     (BenchState& State) { BenchStat(State, RandomCircVals   , [](auto S, auto& Sc) { CircValSmallSet<BenchType> X; CircMedian  (S, X, Sc); DoNotOptimize(X); }); }
+static void BM_CircMedianBruteForce   (BenchState& State) { BenchStat(State, RandomCircVals   , [](auto S, auto&  ) { DoNotOptimize(CircMedianBruteForce(S)); }); }
+
+// throughput cost of the compensated summation mode (compare with the "_Scratch" variants)
+static void BM_CircAverage_Compensated (BenchState& State) { BenchStat(State, RandomCircVals, [](auto S, auto& Sc) { CircValSmallSet<BenchType> X; CircAverage (S, X, Sc, CircSumMode::Compensated); DoNotOptimize(X); }); }
+static void BM_CircAverage2_Compensated(BenchState& State) { BenchStat(State, RandomCircVals, [](auto S, auto& Sc) { CircValSmallSet<BenchType> X; CircAverage2(S, X, Sc, CircSumMode::Compensated); DoNotOptimize(X); }); }
+
+// strong scaling of the parallel CircAverage2: elements/second of a fixed input size over 1..hardware_concurrency threads
+template <unsigned nThreads>
+static void BM_CircAverage2_Threads(BenchState& State)
+{
+    BenchStat(State, RandomCircVals, [](auto S, auto& Sc) { CircValSmallSet<BenchType> X; CircAverage2(S, X, Sc, nThreads); DoNotOptimize(X); });
+}
+
+static void BM_CircAverage2_Fixed16(BenchState& State)
+{
+    const auto                                A = RandomCircVals(State.n(), 1);
+    const vector<CircValFixed<BenchType, 16>> F(A.begin(), A.end());
+    CircStatScratch                           Scratch;
+
+    for (auto _ : State)
+    {
+        CircValSmallSet<BenchType> X;
+        CircAverage2<BenchType, 16>(F, X, Scratch);
+        DoNotOptimize(X);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+// single-precision values, double-precision statistics
+static void BM_CircAverage2_Float(BenchState& State)
+{
+    const auto                              A = RandomCircVals(State.n(), 1);
+    const vector<CircVal<BenchType, float>> F(A.begin(), A.end());
+    CircStatScratch                         Scratch;
+
+    for (auto _ : State)
+    {
+        CircValSmallSet<BenchType, 4, float> X;
+        CircAverage2(F, X, Scratch);
+        DoNotOptimize(X);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_CircMeanResultant(BenchState& State)
+{
+    const auto A = RandomCircVals(State.n(), 1);
+
+    for (auto _ : State)
+        DoNotOptimize(CircMeanResultant(A));
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_CircAverageSketch(BenchState& State) // summarize (1024 buckets), and calculate the average set from the summary
+{
+    const auto A = RandomCircVals(State.n(), 1);
+
+    for (auto _ : State)
+    {
+        CircAverageSketch<BenchType> S;
+        S.Add(A);
+
+        CircValSmallSet<BenchType> X;
+        S.GetAvrg(X);
+        DoNotOptimize(X);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_CircQuantileSketch(BenchState& State) // summarize (k= 1024), and estimate p5, median, p95
+{
+    const auto A = RandomCircVals(State.n(), 1);
+
+    for (auto _ : State)
+    {
+        CircQuantileSketch<BenchType> S;
+        S.Add(A);
+
+        DoNotOptimize(S.Quantile(0.05));
+        DoNotOptimize(S.Median());
+        DoNotOptimize(S.Quantile(0.95));
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BenchWeightedCircAverage(BenchState& State, CircSumMode Mode)
+{
+    const auto           A = RandomCircVals(State.n(), 1);
+    const vector<double> W = RandomReals   (State.n(), 0.5, 2., 2);
+
+    vector<pair<CircVal<BenchType>, double>> WA(State.n());
+    for (size_t i = 0; i < WA.size(); ++i)
+        WA[i] = { A[i], W[i] };
+
+    CircStatScratch Scratch;
+    for (auto _ : State)
+    {
+        CircValSmallSet<BenchType> X;
+        WeightedCircAverage(WA, X, Scratch, Mode);
+        DoNotOptimize(X);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_WeightedCircAverage            (BenchState& State) { BenchWeightedCircAverage(State, CircSumMode::Fast       ); }
+static void BM_WeightedCircAverage_Compensated(BenchState& State) { BenchWeightedCircAverage(State, CircSumMode::Compensated); }
+
+// columnar values and weights: no <value,weight> pairs are built
+static void BM_WeightedCircAverage_Columnar(BenchState& State)
+{
+    const auto           A = RandomCircVals(State.n(), 1);
+    const vector<double> W = RandomReals   (State.n(), 0.5, 2., 2);
+
+    CircStatScratch Scratch;
+    for (auto _ : State)
+    {
+        CircValSmallSet<BenchType> X;
+        WeightedCircAverage(span<const CircVal<BenchType>>(A), span<const double>(W), X, Scratch);
+        DoNotOptimize(X);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+MICROBENCH(BM_CircAverage           )->Range(10, 10000000);
+MICROBENCH(BM_CircAverage_Clustered )->Range(10, 10000000);
+MICROBENCH(BM_CircAverage_Headings  )->Range(10, 10000000);
+MICROBENCH(BM_CircAverage_Scratch   )->Range(10, 10000000);
+MICROBENCH(BM_CircAverage2          )->Range(10, 10000000);
+MICROBENCH(BM_CircAverage2_Clustered)->Range(10, 10000000);
+MICROBENCH(BM_CircAverage2_Headings )->Range(10, 10000000);
+MICROBENCH(BM_CircAverage2_Scratch  )->Range(10, 10000000);
+MICROBENCH(BM_CircAverage2_Fixed16  )->Range(10, 10000000);
+MICROBENCH(BM_CircAverage2_Float    )->Range(10, 10000000);
+MICROBENCH(BM_CircAverage_Compensated )->Range(10, 10000000);
+MICROBENCH(BM_CircAverage2_Compensated)->Range(10, 10000000);
+MICROBENCH(BM_CircAverageLinear     )->Range(10, 10000000);
+MICROBENCH(BM_CircMeanResultant     )->Range(10, 10000000);
+MICROBENCH(BM_CircAverageSketch     )->Range(10, 10000000);
+MICROBENCH(BM_CircQuantileSketch    )->Range(10, 10000000);
+MICROBENCH(BM_WeightedCircAverage   )->Range(10, 10000000);
+MICROBENCH(BM_WeightedCircAverage_Compensated)->Range(10, 10000000);
+MICROBENCH(BM_WeightedCircAverage_Columnar)->Range(10, 10000000);
+MICROBENCH(BM_CircMedian            )->Range(10, 10000000);
+MICROBENCH(BM_CircMedian_Headings   )->Range(10, 10000000);
+MICROBENCH(BM_CircMedian_Tight      )->Range(10, 10000000);
+MICROBENCH(BM_CircMedian_Constant   )->Range(10, 10000000);
+MICROBENCH(BM_CircMedian_Scratch    )->Range(10, 10000000);
+MICROBENCH(BM_CircMedianBruteForce  )->Range(10, 10000   ); // O(n^2)
+
+// BM_CircAverage2_Threads<k>: k = 1, 2, 4, ... up to the number of hardware threads
+static const bool s_bThreadsBench = []
+{
+    const unsigned nMax = max(thread::hardware_concurrency(), 1u);
+    auto Register = [nMax](unsigned nThreads, void (*Func)(BenchState&))
+    {
+        if (nThreads <= nMax)
+            BenchRegistry::Get().Register("BM_CircAverage2_Threads" + to_string(nThreads), Func)->Range(10000000, 10000000);
+    };
+
+    Register( 1, BM_CircAverage2_Threads< 1>);
+    Register( 2, BM_CircAverage2_Threads< 2>);
+    Register( 4, BM_CircAverage2_Threads< 4>);
+    Register( 8, BM_CircAverage2_Threads< 8>);
+    Register(16, BM_CircAverage2_Threads<16>);
+    Register(32, BM_CircAverage2_Threads<32>);
+    Register(64, BM_CircAverage2_Threads<64>);
+    return true;
+}();
+
+// ==========================================================================
+// CircArc
+template <typename F>
+static void BenchArc(BenchState& State, F f)
+{
+    const vector<double> C = RandomReals(State.n(), BenchType::L, BenchType::H, 1);
+    const vector<double> L = RandomReals(State.n(), 0.          , BenchType::R, 2);
+    const auto           V = RandomCircVals(State.n(), 3);
+
+    vector<CircArc<BenchType>> Arcs(State.n());
+    for (size_t i = 0; i < Arcs.size(); ++i)
+        Arcs[i] = CircArc<BenchType>(C[i], L[i]);
+
+    for (auto _ : State)
+    {
+        size_t nCount = 0;
+        for (size_t i = 0; i < Arcs.size(); ++i)
+            nCount += f(Arcs[i], Arcs[Arcs.size() - 1 - i], V[i]);
+        DoNotOptimize(nCount);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_CircArc_Contains (BenchState& State) { BenchArc(State, [](const auto& a, const auto&  , const auto& v) { return a.Contains (v); }); }
+static void BM_CircArc_Intersect(BenchState& State) { BenchArc(State, [](const auto& a, const auto& b, const auto&  ) { return a.Intersect(b); }); }
+
+MICROBENCH(BM_CircArc_Contains )->Range(10, 10000000);
+MICROBENCH(BM_CircArc_Intersect)->Range(10, 10000000);
+
+// ==========================================================================
+// distributions: n values per iteration
+template <typename D>
+static void BenchDist(BenchState& State, D Dist, bool bGenerate)
+{
+    PhiloxEngine   rand_engine(2026, 0);
+    vector<double> Out(State.n());
+
+    for (auto _ : State)
+    {
+        if constexpr (requires { Dist.generate(rand_engine, Out.begin(), Out.end()); })
+            if (bGenerate)
+            {
+                Dist.generate(rand_engine, Out.begin(), Out.end());
+                DoNotOptimize(Out.data());
+                continue;
+            }
+
+        for (auto& r : Out)
+            r = Dist(rand_engine);
+        DoNotOptimize(Out.data());
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_WrappedNormal                  (BenchState& State) { BenchDist(State, wrapped_normal_distribution          <double>(0., 45., -180., 180.                  ), false); }
+static void BM_WrappedNormal_Generate         (BenchState& State) { BenchDist(State, wrapped_normal_distribution          <double>(0., 45., -180., 180.                  ), true ); }
+static void BM_TruncatedNormal                (BenchState& State) { BenchDist(State, truncated_normal_distribution        <double>(0., 45., -40., 40.                    ), false); }
+static void BM_WrappedTruncatedNormal         (BenchState& State) { BenchDist(State, wrapped_truncated_normal_distribution<double>(0., 100., -500., 500., 0., 360.       ), false); }
+static void BM_WrappedTruncatedNormal_InvCDF  (BenchState& State) { BenchDist(State, wrapped_truncated_normal_distribution<double>(0., 100., -500., 500., 0., 360., true ), false); }
+static void BM_WrappedTruncatedNormal_Generate(BenchState& State) { BenchDist(State, wrapped_truncated_normal_distribution<double>(0., 100., -500., 500., 0., 360., true ), true ); }
+
+MICROBENCH(BM_WrappedNormal                  )->Range(10, 10000000);
+MICROBENCH(BM_WrappedNormal_Generate         )->Range(10, 10000000);
+MICROBENCH(BM_TruncatedNormal                )->Range(10, 10000000);
+MICROBENCH(BM_WrappedTruncatedNormal         )->Range(10, 10000000);
+MICROBENCH(BM_WrappedTruncatedNormal_InvCDF  )->Range(10, 10000000);
+MICROBENCH(BM_WrappedTruncatedNormal_Generate)->Range(10, 10000000);
+
+// per-sample cost of each (forced) sampling algorithm over a grid of normalized truncation-ranges.
+// BM_TruncatedNormal_Alg<k>_<NA>_<NB>, BM_WrappedTruncatedNormal_{Alg<k>|InvCDF|Generate}_<NA>_<NB>.
+// algorithms that are impractical for a range are not registered; param_type::alg() tells the one selected by _Init
+static string RangeName(const char* sPrefix, double fNA, double fNB)
+{
+    ostringstream ss;
+    ss << sPrefix << "_" << fNA << "_" << fNB;
+    return ss.str();
+}
+
+static const bool s_bAlgBench = []
+{
+    using tn_param_type  = truncated_normal_distribution        <double>::param_type;
+    using wtn_param_type = wrapped_truncated_normal_distribution<double>::param_type;
+
+    auto Mass = [](double fNA, double fNB) { return (erfc(fNA / sqrt(2.)) - erfc(fNB / sqrt(2.))) / 2.; }; // P(NA <= x <= NB)
+
+    for (const double fNA : { -3., -1., -0.5, 0., 0.5, 2., 4. })
+        for (const double fWidth : { 0.1, 1., 4. })
+        {
+            const double fNB = fNA + fWidth;
+            for (int nAlg = 0; nAlg <= 4; ++nAlg)
+            {
+                if ((nAlg == 0 && Mass(fNA, fNB) < 0.05) || (nAlg == 1 && fNA < 0.) || (nAlg == 2 && fNB > 0.))
+                    continue;
+
+                tn_param_type Par(0., 1., fNA, fNB);
+                Par._Alg = nAlg;                                // force the algorithm
+                if (nAlg == 4)
+                    Par._InitStrips();
+
+                const string sName = RangeName(("BM_TruncatedNormal_Alg" + to_string(nAlg)).c_str(), fNA, fNB);
+                BenchRegistry::Get().Register(sName, [Par](BenchState& State) { BenchDist(State, truncated_normal_distribution<double>(Par), false); })
+                                   ->Range(100, 100);
+            }
+        }
+
+    for (const double fNA : { -3., -1., 0., 0.5, 2., 4., 8. })
+        for (const double fWidth : { 0.01, 0.1, 1., 4. })
+        {
+            const double fNB = fNA + fWidth;
+            for (int nAlg = 0; nAlg <= 5; ++nAlg)
+            {
+                if ((nAlg == 0 && Mass(fNA, fNB) < 0.05) || (nAlg == 1 && fNA < 0.) || (nAlg == 2 && fNB > 0.) || (nAlg == 3 && fWidth > 1. && fNA >= 2.))
+                    continue;
+
+                wtn_param_type Par(0., 1., fNA, fNB, -180., 180., nAlg >= 4); // normalized; wrapping does not change the values
+                if (nAlg < 4)
+                    Par._Alg = nAlg;                            // force the algorithm
+
+                const string sAlg  = nAlg < 4 ? "Alg" + to_string(nAlg) : nAlg == 4 ? "InvCDF" : "Generate";
+                const string sName = RangeName(("BM_WrappedTruncatedNormal_" + sAlg).c_str(), fNA, fNB);
+                BenchRegistry::Get().Register(sName, [Par, nAlg](BenchState& State) { BenchDist(State, wrapped_truncated_normal_distribution<double>(Par), nAlg == 5); })
+                                   ->Range(100, 100);
+            }
+        }
+
+    return true;
+}();
+
+// ==========================================================================
+// random number engines: n canonical values per iteration (as drawn by the distribution classes)
+template <typename E>
+static void BenchEngine(BenchState& State)
+{
+    E      rand_engine;
+    double fSum = 0.;
+
+    for (auto _ : State)
+    {
+        for (size_t i = 0; i < State.n(); ++i)
+            fSum += generate_canonical<double, static_cast<size_t>(-1)>(rand_engine);
+        DoNotOptimize(fSum);
+    }
+
+    State.SetElements((double)State.n());
+}
+
+static void BM_Engine_Default (BenchState& State) { BenchEngine<default_random_engine>(State); }
+static void BM_Engine_Mt19937 (BenchState& State) { BenchEngine<mt19937_64           >(State); }
+static void BM_Engine_Philox  (BenchState& State) { BenchEngine<PhiloxEngine         >(State); }
+
+MICROBENCH(BM_Engine_Default)->Range(10, 10000000);
+MICROBENCH(BM_Engine_Mt19937)->Range(10, 10000000);
+MICROBENCH(BM_Engine_Philox )->Range(10, 10000000);
+
+// ==========================================================================
+int main(int argc, char* argv[])
+{
+    string sFilter  = ".*"     ;
+    size_t nMaxN    = 10000000 ;
+    double fMinTime = 0.05     ;
+    string sFormat  = "console";
+    string sOut                ;
+    string sCompare            ;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const string sArg = argv[i];
+        auto Value = [&](const char* sName) -> const char*
+        {
+            const size_t nLen = strlen(sName);
+            return sArg.compare(0, nLen, sName) == 0 ? argv[i] + nLen : nullptr;
+        };
+
+             if (const char* s = Value("--filter="  )) sFilter  = s;
+        else if (const char* s = Value("--max_n="   )) nMaxN    = stoull(s);
+        else if (const char* s = Value("--min_time=")) fMinTime = stod(s);
+        else if (const char* s = Value("--format="  )) sFormat  = s;
+        else if (const char* s = Value("--out="     )) sOut     = s;
+        else if (const char* s = Value("--compare=" )) sCompare = s;
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--filter=<regex>] [--max_n=<n>] [--min_time=<seconds>] [--format=console|csv|json] [--out=<file>] [--compare=<file>]" << endl;
+            return 1;
+        }
+    }
+
+    vector<BenchRegistry::Result> Baseline;
+    if (!sCompare.empty())
+    {
+        ifstream fBaseline(sCompare);
+        if (!fBaseline)
+        {
+            cerr << "cannot read " << sCompare << endl;
+            return 1;
+        }
+        Baseline = BenchRegistry::ReadCSV(fBaseline);
+    }
+
+    const auto Results = BenchRegistry::Get().Run(sFilter, nMaxN, fMinTime, &cerr);
+
+    ofstream f;
+    if (!sOut.empty())
+        f.open(sOut);
+    ostream& os = sOut.empty() ? cout : f;
+
+    if (!sCompare.empty())
+    {
+        BenchRegistry::WriteComparison(os, Baseline, Results, sFormat == "csv");
+        return 0;
+    }
+
+         if (sFormat == "csv" ) BenchRegistry::WriteCSV (os, Results);
+    else if (sFormat == "json") BenchRegistry::WriteJSON(os, Results);
+    else if (!sOut.empty())     for (const auto& r : Results) os << BenchRegistry::ToText(r) << "\n";
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+# ==========================================================================
+# Copyright (C) 2026 Lior Kogan (koganlior1@gmail.com)
+# ==========================================================================
+# PGO-vs-plain comparison of circular_bench (gcc/clang):
+#   1. plain build (CIRCULAR_PGO=OFF): run the report benchmarks -> plain.csv
+#   2. instrumented build (CIRCULAR_PGO=GENERATE): run the training workloads -> profile
+#   3. the same build directory, rebuilt with CIRCULAR_PGO=USE: run the report benchmarks, compared against plain.csv
+#      (gcc names the profile files after the object paths - so the USE build must reuse the GENERATE build directory)
+#
+# training workloads: the Wrap/Sdist/CircAverage/CircAverage2/CircMedian benchmarks of CircularBench.cpp,
+# over uniform, clustered and wrapped-normal (Headings, around the wrap point) inputs
+#
+# cmake [-D<var>=<value>...] -P CircularPgo.cmake       (or: cmake --build <build> --target circular_pgo_report)
+#   CXX_COMPILER  - C++ compiler (default: cmake's default)
+#   WORK_DIR      - build directories, profile and reports (default: <source>/_pgo)
+#   TRAIN_FILTER  - benchmarks run for training (regex)
+#   TRAIN_MAX_N   - largest problem size of the training run (default: 100000)
+#   REPORT_FILTER - benchmarks compared (regex, default: TRAIN_FILTER)
+#   REPORT_MAX_N  - largest problem size of the comparison (default: 1000000)
+#   MIN_TIME      - minimal timed-loop time of the comparison [s] (default: 0.2)
+#
+# outputs (WORK_DIR): plain.csv (plain build results), pgo_report.txt (per (benchmark, n): plain and PGO ns/element, speedup;
+# geometric-mean speedup per benchmark and overall)
+# ==========================================================================
+
+cmake_minimum_required(VERSION 3.16)
+
+get_filename_component(SOURCE_DIR "${CMAKE_CURRENT_LIST_DIR}" ABSOLUTE)
+
+if (NOT WORK_DIR)
+    set(WORK_DIR "${SOURCE_DIR}/_pgo")
+endif()
+if (NOT TRAIN_FILTER)
+    set(TRAIN_FILTER "^BM_(Wrap|Sdist|CircAverage|CircAverage2|CircMedian)(_|$)")
+endif()
+if (NOT TRAIN_MAX_N)
+    set(TRAIN_MAX_N 100000)
+endif()
+if (NOT REPORT_FILTER)
+    set(REPORT_FILTER "${TRAIN_FILTER}")
+endif()
+if (NOT REPORT_MAX_N)
+    set(REPORT_MAX_N 1000000)
+endif()
+if (NOT MIN_TIME)
+    set(MIN_TIME 0.2)
+endif()
+
+set(ProfileDir "${WORK_DIR}/profile")
+set(CommonArgs -DCMAKE_BUILD_TYPE=Release -DCIRCULAR_SANITIZERS=OFF -DCIRCULAR_PGO_DIR=${ProfileDir})
+if (CXX_COMPILER)
+    list(APPEND CommonArgs -DCMAKE_CXX_COMPILER=${CXX_COMPILER})
+endif()
+
+# run a command; stop on failure
+function(circular_run)
+    execute_process(COMMAND ${ARGN} RESULT_VARIABLE nResult)
+    if (NOT nResult EQUAL 0)
+        message(FATAL_ERROR "failed (${nResult}): ${ARGN}")
+    endif()
+endfunction()
+
+# configure and build circular_bench in BuildDir with the given PGO mode
+function(circular_build BuildDir PgoMode)
+    message(STATUS "circular_bench: CIRCULAR_PGO=${PgoMode} (${BuildDir})")
+    circular_run(${CMAKE_COMMAND} -S ${SOURCE_DIR} -B ${BuildDir} ${CommonArgs} -DCIRCULAR_PGO=${PgoMode})
+    circular_run(${CMAKE_COMMAND} --build ${BuildDir} --target circular_bench --clean-first -j)
+endfunction()
+
+# ==========================================================================
+# 1. plain
+circular_build(${WORK_DIR}/plain OFF)
+circular_run(${WORK_DIR}/plain/circular_bench --filter=${REPORT_FILTER} --max_n=${REPORT_MAX_N} --min_time=${MIN_TIME}
+             --format=csv --out=${WORK_DIR}/plain.csv)
+
+# 2. train
+file(REMOVE_RECURSE ${ProfileDir})
+circular_build(${WORK_DIR}/pgo GENERATE)
+circular_run(${WORK_DIR}/pgo/circular_bench --filter=${TRAIN_FILTER} --max_n=${TRAIN_MAX_N} --min_time=0.01
+             --format=csv --out=${WORK_DIR}/train.csv)
+
+# clang writes raw profiles, which are merged into default.profdata
+file(GLOB RawProfiles ${ProfileDir}/*.profraw)
+if (RawProfiles)
+    find_program(LLVM_PROFDATA NAMES llvm-profdata)
+    if (NOT LLVM_PROFDATA)
+        message(FATAL_ERROR "llvm-profdata not found: cannot merge the clang profiles")
+    endif()
+    circular_run(${LLVM_PROFDATA} merge -o ${ProfileDir}/default.profdata ${RawProfiles})
+endif()
+
+# 3. optimize with the profile, compare
+circular_build(${WORK_DIR}/pgo USE)
+circular_run(${WORK_DIR}/pgo/circular_bench --filter=${REPORT_FILTER} --max_n=${REPORT_MAX_N} --min_time=${MIN_TIME}
+             --compare=${WORK_DIR}/plain.csv --out=${WORK_DIR}/pgo_report.txt)
+
+file(READ ${WORK_DIR}/pgo_report.txt sReport)
+message("${sReport}")
+message(STATUS "PGO-vs-plain report: ${WORK_DIR}/pgo_report.txt")
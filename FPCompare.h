@@ -235,6 +235,13 @@ public:
         return bits <= kMaxUlps;
   }
 
+    // Lior Kogan: returns the distance between this number and rhs, in ULP's
+    // (thinks +0.0 and -0.0 are 0 ULP's apart). neither number should be NAN
+    Bits UlpDistance(const FloatingPoint& rhs) const
+    {
+        return DistanceBetweenSignAndMagnitudeNumbers(u_.bits_, rhs.u_.bits_);
+    }
+
  private:
     // The data type used to store the actual floating-point number.
     union FloatingPointUnion
@@ -296,6 +303,21 @@ static bool IsAlmostEq(T x, T y)
     return f.AlmostEquals(g);
 }
 
+// check if two floating-points are at most nMaxUlps ULP's apart (false if either is NAN)
+template<typename T>
+static bool IsWithinUlps(T x, T y, size_t nMaxUlps)
+{
+    static_assert(!std::numeric_limits<T>::is_exact , "IsWithinUlps: floating-point type expected");
+
+    FloatingPoint<T> f(x);
+    FloatingPoint<T> g(y);
+
+    if (f.is_nan() || g.is_nan())
+        return false;
+
+    return f.UlpDistance(g) <= nMaxUlps;
+}
+
 // assert that 2 floating-points are almost equal
 [[maybe_unused]] static void AssertAlmostEq([[maybe_unused]]const double f, [[maybe_unused]]const double g)
 {
@@ -0,0 +1,472 @@
+// ==========================================================================
+// Copyright (C) 2026 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+// classes defined here:
+// BenchCycleCounter  - CPU cycles counter (Linux perf_event)
+// BenchState         - state of a running micro-benchmark (Google-Benchmark style)
+// BenchRegistry      - registered micro-benchmarks, runner and reports
+//
+// functions defined here:
+// DoNotOptimize      - prevent the compiler from optimizing away a value
+// BenchAllocCount    - number of heap allocations so far (if counted - see MICROBENCH_COUNT_ALLOCATIONS)
+//
+// usage:
+//   static void BM_Foo(BenchState& State)
+//   {
+//       auto Input = MakeInput(State.n());                // setup - not timed
+//       for (auto _ : State)                              // timed loop
+//           DoNotOptimize(Foo(Input));
+//       State.SetElements(State.n());                     // elements per iteration (for ns/element)
+//   }
+//   MICROBENCH(BM_Foo)->Range(10, 10000000);              // n = 10, 100, ..., 10^7
+//
+// each (benchmark, n) is run with a growing number of iterations until the timed loop takes at least the minimal time.
+// reported per (benchmark, n): ns/element, heap allocations per iteration, and CPU cycles/element (Linux perf counters;
+// omitted when not available). the CSV report has one line per (benchmark, n), in registration order - diffable across commits.
+// WriteComparison compares a run against a baseline CSV report (e.g. a PGO build against a plain build)
+// ==========================================================================
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <atomic>
+#include <regex>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>       // std::max, std::min
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+// ==========================================================================
+// prevent the compiler from optimizing away a value (and the computation of the value)
+template <typename T>
+inline void DoNotOptimize(const T& v)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(v) : "memory");
+#else
+    static volatile const void* s_pSink;
+    s_pSink = &v;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// ==========================================================================
+// heap allocations counter. the benchmark driver counts the allocations by defining MICROBENCH_COUNT_ALLOCATIONS
+// before including this header (once - in the translation unit with main), which replaces the global operator new
+inline std::atomic<uint64_t> g_nBenchAllocs{0};
+
+inline uint64_t BenchAllocCount()
+{
+    return g_nBenchAllocs.load(std::memory_order_relaxed);
+}
+
+#if defined(MICROBENCH_COUNT_ALLOCATIONS)
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>        // _aligned_malloc
+#endif
+
+void* operator new(size_t n)
+{
+    g_nBenchAllocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t n, std::align_val_t a)
+{
+    g_nBenchAllocs.fetch_add(1, std::memory_order_relaxed);
+    void* p = nullptr;
+#if defined(_MSC_VER)
+    p = _aligned_malloc(n ? n : 1, (size_t)a);
+#else
+    if (posix_memalign(&p, std::max((size_t)a, sizeof(void*)), n ? n : 1) != 0)
+        p = nullptr;
+#endif
+    if (p)
+        return p;
+    throw std::bad_alloc();
+}
+
+// the replacement deletes free through these non-inlined functions: gcc would otherwise see std::free called on the
+// pointer returned by the (inlined) replacement operator new, and warn (-Wmismatched-new-delete)
+#if defined(_MSC_VER)
+#define MICROBENCH_NOINLINE __declspec(noinline)
+#else
+#define MICROBENCH_NOINLINE __attribute__((noinline))
+#endif
+
+MICROBENCH_NOINLINE inline void BenchFree(void* p)
+{
+    std::free(p);
+}
+
+MICROBENCH_NOINLINE inline void BenchAlignedFree(void* p)
+{
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* operator new[](size_t n)                                        { return operator new(n);    }
+void* operator new[](size_t n, std::align_val_t a)                    { return operator new(n, a); }
+void  operator delete  (void* p) noexcept                             { BenchFree(p);              }
+void  operator delete[](void* p) noexcept                             { BenchFree(p);              }
+void  operator delete  (void* p, size_t) noexcept                     { BenchFree(p);              }
+void  operator delete[](void* p, size_t) noexcept                     { BenchFree(p);              }
+void  operator delete  (void* p, std::align_val_t) noexcept           { BenchAlignedFree(p);       }
+void  operator delete[](void* p, std::align_val_t) noexcept           { BenchAlignedFree(p);       }
+void  operator delete  (void* p, size_t, std::align_val_t) noexcept   { BenchAlignedFree(p);       }
+void  operator delete[](void* p, size_t, std::align_val_t) noexcept   { BenchAlignedFree(p);       }
+#endif
+
+// ==========================================================================
+// CPU cycles counter of the calling thread (Linux perf_event). Read() returns 0 when not available
+class BenchCycleCounter
+{
+    int m_fd = -1;
+
+public:
+    BenchCycleCounter()
+    {
+#if defined(__linux__)
+        perf_event_attr Attr{};
+        Attr.type           = PERF_TYPE_HARDWARE;
+        Attr.size           = sizeof(Attr);
+        Attr.config         = PERF_COUNT_HW_CPU_CYCLES;
+        Attr.exclude_kernel = 1;
+        Attr.exclude_hv     = 1;
+        m_fd = (int)syscall(__NR_perf_event_open, &Attr, 0, -1, -1, 0);
+        if (m_fd >= 0)
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    ~BenchCycleCounter()
+    {
+#if defined(__linux__)
+        if (m_fd >= 0)
+            close(m_fd);
+#endif
+    }
+
+    BenchCycleCounter(const BenchCycleCounter&) = delete;
+    BenchCycleCounter& operator=(const BenchCycleCounter&) = delete;
+
+    bool IsAvailable() const { return m_fd >= 0; }
+
+    uint64_t Read() const
+    {
+        uint64_t n = 0;
+#if defined(__linux__)
+        if (m_fd >= 0 && read(m_fd, &n, sizeof(n)) != (ssize_t)sizeof(n))
+            n = 0;
+#endif
+        return n;
+    }
+};
+
+// ==========================================================================
+// state of a running micro-benchmark: the range-for loop over the state is the timed part
+class BenchState
+{
+    size_t                                m_n        ;
+    size_t                                m_nIters   ;
+    double                                m_fElements = 1.; // elements per iteration
+    const BenchCycleCounter&              m_Cycles   ;
+
+    std::chrono::steady_clock::time_point m_Time0    ;
+    uint64_t                              m_nAllocs0  = 0;
+    uint64_t                              m_nCycles0  = 0;
+
+public:
+    double                                m_fTime     = 0.; // [s]
+    uint64_t                              m_nAllocs   = 0 ;
+    uint64_t                              m_nCycles   = 0 ;
+
+    BenchState(size_t n, size_t nIters, const BenchCycleCounter& Cycles) : m_n(n), m_nIters(nIters), m_Cycles(Cycles)
+    {
+    }
+
+    size_t n          () const         { return m_n;         } // problem size
+    size_t Iterations () const         { return m_nIters;    }
+    double Elements   () const         { return m_fElements; }
+    void   SetElements(double f)       { m_fElements = f;    } // elements per iteration (default: 1)
+
+    void Start()
+    {
+        m_nAllocs0 = BenchAllocCount();
+        m_nCycles0 = m_Cycles.Read();
+        m_Time0    = std::chrono::steady_clock::now();
+    }
+
+    void Stop()
+    {
+        const auto Time1 = std::chrono::steady_clock::now();
+        m_nCycles = m_Cycles.Read() - m_nCycles0;
+        m_nAllocs = BenchAllocCount() - m_nAllocs0;
+        m_fTime   = std::chrono::duration<double>(Time1 - m_Time0).count();
+    }
+
+    // the value of the timed loop's variable: [[maybe_unused]], so 'for (auto _ : State)' does not warn (-Wunused-variable)
+    struct [[maybe_unused]] Value {};
+
+    struct Iterator
+    {
+        BenchState* m_pState;
+        size_t      m_nLeft ;
+
+        Value operator*() const { return {}; }
+        void operator++()       { --m_nLeft; }
+
+        bool operator!=(const Iterator&)
+        {
+            if (m_nLeft > 0)
+                return true;
+
+            m_pState->Stop();
+            return false;
+        }
+    };
+
+    Iterator begin() { Start(); return { this, m_nIters }; }
+    Iterator end  () {          return { this, 0        }; }
+};
+
+// ==========================================================================
+// registered micro-benchmarks
+class BenchRegistry
+{
+public:
+    struct Benchmark
+    {
+        std::string                      sName;
+        std::function<void(BenchState&)> Func ;
+        std::vector<size_t>              Sizes = { 1 };
+
+        // n = nMin, nMin*10, ..., nMax
+        Benchmark* Range(size_t nMin, size_t nMax)
+        {
+            Sizes.clear();
+            for (size_t n = nMin; n <= nMax; n *= 10)
+                Sizes.push_back(n);
+            return this;
+        }
+    };
+
+    struct Result
+    {
+        std::string sName      ;
+        size_t      n          ;
+        size_t      nIters     ;
+        double      fNsPerElem ;
+        double      fAllocsPerIter;
+        double      fCyclesPerElem; // NaN: not available
+    };
+
+private:
+    std::deque<Benchmark> m_Benchmarks; // stable addresses
+
+public:
+    static BenchRegistry& Get()
+    {
+        static BenchRegistry s_Registry;
+        return s_Registry;
+    }
+
+    Benchmark* Register(std::string sName, std::function<void(BenchState&)> Func)
+    {
+        m_Benchmarks.push_back({ std::move(sName), std::move(Func) });
+        return &m_Benchmarks.back();
+    }
+
+    // run the benchmarks whose name matches the filter, for n <= nMaxN. fMinTime: minimal timed-loop time [s]
+    std::vector<Result> Run(const std::string& sFilter, size_t nMaxN, double fMinTime, std::ostream* pProgress = nullptr) const
+    {
+        const std::regex  Filter(sFilter);
+        BenchCycleCounter Cycles;
+        std::vector<Result> Results;
+
+        for (const Benchmark& B : m_Benchmarks)
+        {
+            if (!std::regex_search(B.sName, Filter))
+                continue;
+
+            for (const size_t n : B.Sizes)
+            {
+                if (n > nMaxN)
+                    continue;
+
+                for (size_t nIters = 1; ; )
+                {
+                    BenchState State(n, nIters, Cycles);
+                    B.Func(State);
+
+                    if (State.m_fTime >= fMinTime || nIters >= (size_t(1) << 40))
+                    {
+                        const double fElems = State.Elements() * nIters;
+                        Results.push_back({ B.sName, n, nIters, State.m_fTime * 1e9 / fElems, (double)State.m_nAllocs / nIters,
+                                            Cycles.IsAvailable() ? State.m_nCycles / fElems : std::nan("") });
+                        if (pProgress)
+                            *pProgress << ToText(Results.back()) << std::endl;
+                        break;
+                    }
+
+                    // next number of iterations: aim at 1.4x the minimal time, grow at most 10x
+                    const double fScale = State.m_fTime > 0. ? fMinTime * 1.4 / State.m_fTime : 10.;
+                    nIters = std::max(nIters + 1, (size_t)(nIters * std::min(10., fScale)));
+                }
+            }
+        }
+
+        return Results;
+    }
+
+    // ---------------------------------------------
+    static std::string ToText(const Result& r)
+    {
+        std::ostringstream ss;
+        ss << std::left << std::setw(40) << (r.sName + "/" + std::to_string(r.n)) << std::right << std::fixed
+           << std::setprecision(3) << std::setw(14) << r.fNsPerElem     << " ns/elem"
+           << std::setprecision(2) << std::setw(10) << r.fAllocsPerIter << " allocs";
+        if (!std::isnan(r.fCyclesPerElem))
+            ss << std::setprecision(2) << std::setw(12) << r.fCyclesPerElem << " cycles/elem";
+        ss << std::setw(12) << r.nIters << " iters";
+        return ss.str();
+    }
+
+    static void WriteCSV(std::ostream& os, const std::vector<Result>& Results)
+    {
+        std::ostringstream ss;
+        ss << "name,n,iterations,ns_per_element,allocs_per_iteration,cycles_per_element\n";
+        for (const Result& r : Results)
+        {
+            ss << r.sName << "," << r.n << "," << r.nIters << "," << std::setprecision(6) << r.fNsPerElem << "," << r.fAllocsPerIter << ",";
+            if (!std::isnan(r.fCyclesPerElem))
+                ss << r.fCyclesPerElem;
+            ss << "\n";
+        }
+
+        os << ss.str();
+    }
+
+    // read a report written by WriteCSV
+    static std::vector<Result> ReadCSV(std::istream& is)
+    {
+        std::vector<Result> Results;
+        std::string         sLine;
+        std::getline(is, sLine); // header
+
+        while (std::getline(is, sLine))
+        {
+            if (!sLine.empty() && sLine.back() == '\r')
+                sLine.pop_back();
+            if (sLine.empty())
+                continue;
+
+            std::vector<std::string> Fields;
+            std::istringstream       ss(sLine);
+            for (std::string s; std::getline(ss, s, ','); )
+                Fields.push_back(s);
+            if (Fields.size() < 5)
+                continue;
+
+            Results.push_back({ Fields[0], std::stoull(Fields[1]), std::stoull(Fields[2]), std::stod(Fields[3]), std::stod(Fields[4]),
+                                Fields.size() > 5 && !Fields[5].empty() ? std::stod(Fields[5]) : std::nan("") });
+        }
+
+        return Results;
+    }
+
+    // compare a run against a baseline: per (benchmark, n) of the run, the baseline and run ns/element and the speedup
+    // (baseline/run; > 1: the run is faster), and the geometric-mean speedup per benchmark and overall.
+    // (benchmark, n) pairs missing from the baseline are skipped
+    static void WriteComparison(std::ostream& os, const std::vector<Result>& Baseline, const std::vector<Result>& Results, bool bCSV)
+    {
+        std::ostringstream ss;
+        if (bCSV) ss << "name,n,baseline_ns_per_element,ns_per_element,speedup\n";
+        else      ss << std::left << std::setw(40) << "benchmark/n" << std::right << std::setw(14) << "baseline ns" << std::setw(14) << "ns" << std::setw(10) << "speedup" << "\n";
+
+        std::string sName;
+        double      fLogSum  = 0., fTotalLogSum = 0.;
+        size_t      nCount   = 0 , nTotalCount  = 0 ;
+
+        auto Summary = [&](const std::string& sLabel, double fLog, size_t n)
+        {
+            if (n == 0 || bCSV)
+                return;
+            ss << std::left << std::setw(40) << sLabel << std::right << std::setw(38) << std::fixed << std::setprecision(3) << std::exp(fLog / n) << "\n";
+        };
+
+        for (const Result& r : Results)
+        {
+            const auto b = std::find_if(Baseline.begin(), Baseline.end(), [&](const Result& b) { return b.sName == r.sName && b.n == r.n; });
+            if (b == Baseline.end())
+                continue;
+
+            if (r.sName != sName)
+            {
+                Summary(sName + " (geomean)", fLogSum, nCount);
+                sName   = r.sName;
+                fLogSum = 0.;
+                nCount  = 0 ;
+            }
+
+            const double fSpeedup = b->fNsPerElem / r.fNsPerElem;
+            fLogSum      += std::log(fSpeedup); ++nCount;
+            fTotalLogSum += std::log(fSpeedup); ++nTotalCount;
+
+            if (bCSV) ss << r.sName << "," << r.n << "," << std::setprecision(6) << b->fNsPerElem << "," << r.fNsPerElem << "," << fSpeedup << "\n";
+            else      ss << std::left << std::setw(40) << (r.sName + "/" + std::to_string(r.n)) << std::right << std::fixed << std::setprecision(3)
+                         << std::setw(14) << b->fNsPerElem << std::setw(14) << r.fNsPerElem << std::setw(10) << fSpeedup << "\n";
+        }
+
+        Summary(sName + " (geomean)", fLogSum     , nCount     );
+        Summary("all (geomean)"     , fTotalLogSum, nTotalCount);
+        os << ss.str();
+    }
+
+    static void WriteJSON(std::ostream& os, const std::vector<Result>& Results)
+    {
+        std::ostringstream ss;
+        ss << std::setprecision(6) << "{\n  \"benchmarks\": [";
+        for (size_t i = 0; i < Results.size(); ++i)
+        {
+            const Result& r = Results[i];
+            ss << (i ? "," : "") << "\n    { \"name\": \"" << r.sName << "\", \"n\": " << r.n << ", \"iterations\": " << r.nIters
+               << ", \"ns_per_element\": " << r.fNsPerElem << ", \"allocs_per_iteration\": " << r.fAllocsPerIter
+               << ", \"cycles_per_element\": ";
+            if (std::isnan(r.fCyclesPerElem)) ss << "null";
+            else                              ss << r.fCyclesPerElem;
+            ss << " }";
+        }
+
+        ss << "\n  ]\n}\n";
+        os << ss.str();
+    }
+};
+
+// register a benchmark function; returns BenchRegistry::Benchmark* (e.g. for ->Range(10, 10000000))
+#define MICROBENCH_CONCAT2(a, b) a##b
+#define MICROBENCH_CONCAT(a, b)  MICROBENCH_CONCAT2(a, b)
+#define MICROBENCH(Func)         MICROBENCH_NAMED(#Func, Func)
+#define MICROBENCH_NAMED(sName, Func) \
+    static BenchRegistry::Benchmark* MICROBENCH_CONCAT(s_pBench_, __LINE__) = BenchRegistry::Get().Register(sName, Func)
@@ -0,0 +1,220 @@
+// ==========================================================================
+// Copyright (C) 2026 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+// classes defined here:
+// PhiloxEngine       - counter-based random number engine (Philox4x32-10), with independent streams
+// PhiloxEngineTester - tester for PhiloxEngine class
+// ==========================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <array>
+#include <algorithm>       // std::find
+#include <assert.h>
+
+// ==========================================================================
+// counter-based random number engine - Philox4x32-10
+// Salmon, J. K. et al. Parallel Random Numbers: As Easy as 1, 2, 3 (SC 2011)
+//
+// the n'th output block is a bijection (10 rounds, keyed by the seed) of the 128-bit counter (n, stream_id),
+// so the engine state is just (seed, stream_id, n):
+// - engines with the same seed and different stream_ids produce independent sequences - one engine per thread/task,
+//   with no shared state. the results of parallel simulations are reproducible, and do not depend on the scheduling
+// - discard(n) is O(1)
+// the blocks are computed 4 at a time, so the 10 rounds of independent blocks overlap (and can be vectorized)
+//
+// satisfies the UniformRandomBitGenerator requirements with 64-bit results, so std::generate_canonical<double>
+// (and _NRAND in the distribution classes) takes a single call per value
+class PhiloxEngine
+{
+public:
+    typedef uint64_t result_type;
+
+    static constexpr result_type (min)() { return 0;                                       }
+    static constexpr result_type (max)() { return std::numeric_limits<result_type>::max(); }
+
+private:
+    static constexpr uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57; // round multipliers
+    static constexpr uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85; // key schedule (Weyl sequence)
+
+    static constexpr unsigned N = 4;  // blocks computed together (independent lanes, which the compiler can vectorize)
+
+    uint64_t                  m_nSeed  ; // key
+    uint64_t                  m_nStream; // high 64 bits of the counter
+    uint64_t                  m_nBlock ; // low  64 bits of the counter: next block
+    std::array<uint64_t, 2*N> m_Out    ; // current N blocks
+    unsigned                  m_nOut   ; // number of used values of the current blocks
+
+public:
+    // the 10-round Philox4x32 bijection of the counter c, keyed by k
+    static std::array<uint32_t, 4> Block(std::array<uint32_t, 4> c, std::array<uint32_t, 2> k)
+    {
+        for (int r = 0; r < 10; ++r)
+        {
+            if (r > 0)
+            {
+                k[0] += W0;
+                k[1] += W1;
+            }
+
+            const uint64_t p0 = uint64_t(M0) * c[0];
+            const uint64_t p1 = uint64_t(M1) * c[2];
+            c = { uint32_t(p1 >> 32) ^ c[1] ^ k[0], uint32_t(p1),
+                  uint32_t(p0 >> 32) ^ c[3] ^ k[1], uint32_t(p0) };
+        }
+
+        return c;
+    }
+
+    // ---------------------------------------------
+    explicit PhiloxEngine(uint64_t nSeed = 0, uint64_t nStream = 0)
+    {
+        seed(nSeed, nStream);
+    }
+
+    void seed(uint64_t nSeed = 0, uint64_t nStream = 0)
+    {
+        m_nSeed   = nSeed  ;
+        m_nStream = nStream;
+        m_nBlock  = 0      ;
+        m_nOut    = 2*N    ; // no current blocks
+    }
+
+    result_type operator()()
+    {
+        if (m_nOut == 2*N)
+            Refill();
+
+        return m_Out[m_nOut++];
+    }
+
+    // skip n values
+    void discard(unsigned long long n)
+    {
+        const unsigned long long nLeft = 2*N - m_nOut; // left in the current blocks
+        if (n <= nLeft)
+        {
+            m_nOut += unsigned(n);
+            return;
+        }
+
+        n -= nLeft;
+        m_nBlock += n / (2*N) * N;
+        Refill();
+        m_nOut = unsigned(n % (2*N));
+    }
+
+    bool operator==(const PhiloxEngine& e) const
+    {
+        return m_nSeed == e.m_nSeed && m_nStream == e.m_nStream && m_nBlock == e.m_nBlock && m_nOut == e.m_nOut &&
+               (m_nOut == 2*N || m_Out == e.m_Out);
+    }
+
+private:
+    // compute the next N blocks - same as N calls of Block(), with the rounds interleaved
+    void Refill()
+    {
+        uint32_t c0[N], c1[N], c2[N], c3[N];
+        for (unsigned j = 0; j < N; ++j)
+        {
+            c0[j] = uint32_t( m_nBlock + j       );
+            c1[j] = uint32_t((m_nBlock + j) >> 32);
+            c2[j] = uint32_t( m_nStream          );
+            c3[j] = uint32_t( m_nStream     >> 32);
+        }
+
+        uint32_t k0 = uint32_t(m_nSeed), k1 = uint32_t(m_nSeed >> 32);
+        for (int r = 0; r < 10; ++r)
+        {
+            if (r > 0)
+            {
+                k0 += W0;
+                k1 += W1;
+            }
+
+            for (unsigned j = 0; j < N; ++j)
+            {
+                const uint64_t p0 = uint64_t(M0) * c0[j];
+                const uint64_t p1 = uint64_t(M1) * c2[j];
+                c0[j] = uint32_t(p1 >> 32) ^ c1[j] ^ k0;
+                c2[j] = uint32_t(p0 >> 32) ^ c3[j] ^ k1;
+                c1[j] = uint32_t(p1);
+                c3[j] = uint32_t(p0);
+            }
+        }
+
+        for (unsigned j = 0; j < N; ++j)
+        {
+            m_Out[2*j  ] = uint64_t(c1[j]) << 32 | c0[j];
+            m_Out[2*j+1] = uint64_t(c3[j]) << 32 | c2[j];
+        }
+
+        m_nBlock += N;
+        m_nOut    = 0;
+    }
+};
+
+// ==========================================================================
+// tester for PhiloxEngine class
+class PhiloxEngineTester
+{
+public:
+    PhiloxEngineTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        // known-answer tests (Random123 kat_vectors)
+        assert((PhiloxEngine::Block({ 0x00000000, 0x00000000, 0x00000000, 0x00000000 }, { 0x00000000, 0x00000000 }) ==
+                std::array<uint32_t, 4>{ 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 }));
+        assert((PhiloxEngine::Block({ 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, { 0xffffffff, 0xffffffff }) ==
+                std::array<uint32_t, 4>{ 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd }));
+        assert((PhiloxEngine::Block({ 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, { 0xa4093822, 0x299f31d0 }) ==
+                std::array<uint32_t, 4>{ 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }));
+
+        // the engine's n'th pair of values is the n'th block of its stream
+        {
+            PhiloxEngine e(0x299f31d0a4093822, 0x0370734413198a2e);
+            for (uint32_t n = 0; n < 11; ++n)
+            {
+                [[maybe_unused]] const auto b = PhiloxEngine::Block({ n, 0, 0x13198a2e, 0x03707344 }, { 0xa4093822, 0x299f31d0 });
+                assert(e() == (uint64_t(b[1]) << 32 | b[0]));
+                assert(e() == (uint64_t(b[3]) << 32 | b[2]));
+            }
+        }
+
+        // reproducibility, and independence of streams
+        const size_t count = 1000;
+        PhiloxEngine e1(1234, 0), e2(1234, 0), e3(1234, 1), e4(1235, 0);
+        std::array<uint64_t, count> V1, V3, V4;
+        for (size_t i = 0; i < count; ++i)
+        {
+            V1[i] = e1();
+            V3[i] = e3();
+            V4[i] = e4();
+            assert(e2() == V1[i]);
+        }
+
+        assert(e1 == e2);
+        for (size_t i = 0; i < count; ++i)
+            assert(std::find(V3.begin(), V3.end(), V1[i]) == V3.end() && std::find(V4.begin(), V4.end(), V1[i]) == V4.end());
+
+        // discard(n) == n calls
+        for (unsigned long long n : { 0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 100 })
+            for (unsigned nPre : { 0, 1, 2, 7, 8, 9 })
+            {
+                PhiloxEngine a(99, 5), b(99, 5);
+                for (unsigned i = 0; i < nPre; ++i) { a(); b(); }
+
+                a.discard(n);
+                for (unsigned long long i = 0; i < n; ++i)
+                    b();
+
+                assert(a() == b());
+            }
+    }
+};
@@ -9,7 +9,12 @@
 #pragma once
 
 #include <random>
-#include "CircHelper.h" // Sqr, Mod
+#include <cmath>
+#include <span>
+#include <numbers>      // std::numbers::sqrt2
+#include <iterator>     // std::distance
+#include "CircHelper.h" // Sqr, Mod, NormalQuantile
+#include "CircSimd.h"   // SimdWrap
 
 #define _NRAND(eng, resty) \
     (std::generate_canonical<resty, static_cast<size_t>(-1)>(eng))
@@ -30,9 +35,9 @@ public:
     {   // parameter package
         typedef _Myt distribution_type;
 
-        explicit param_type(_Ty _Mean0 = 0., _Ty _Sigma0 = 1., _Ty _A0 = 0., _Ty _B0 = 0., _Ty _L0 = 0., _Ty _H0 = 0.)
+        explicit param_type(_Ty _Mean0 = 0., _Ty _Sigma0 = 1., _Ty _A0 = 0., _Ty _B0 = 0., _Ty _L0 = 0., _Ty _H0 = 0., bool _InvCDF0 = false)
         {   // construct from parameters
-            _Init(_Mean0, _Sigma0, _A0, _B0, _L0, _H0);
+            _Init(_Mean0, _Sigma0, _A0, _B0, _L0, _H0, _InvCDF0);
         }
 
         bool operator==(const param_type& _Right) const
@@ -42,7 +47,8 @@ public:
                    _A     == _Right._A     &&
                    _B     == _Right._B     &&
                    _L     == _Right._L     &&
-                   _H     == _Right._H        ;
+                   _H     == _Right._H     &&
+                   _InvCDF== _Right._InvCDF   ;
         }
 
         bool operator!=(const param_type& _Right) const
@@ -90,7 +96,12 @@ public:
             return _Alg;
         }
 
-        void _Init(_Ty _Mean0, _Ty _Sigma0, _Ty _A0, _Ty _B0, _Ty _L0, _Ty _H0)
+        bool inverse_cdf() const
+        {   // return whether the rejection-free inverse-CDF sampling was requested
+            return _InvCDF;
+        }
+
+        void _Init(_Ty _Mean0, _Ty _Sigma0, _Ty _A0, _Ty _B0, _Ty _L0, _Ty _H0, bool _InvCDF0 = false)
         {   // set internal state
             if (_Sigma0 <  0.) throw std::domain_error("invalid sigma argument for wrapped_truncated_normal_distribution"  );
             if (_B0     < _A0) throw std::logic_error ("invalid truncation-range for wrapped_truncated_normal_distribution");
@@ -110,6 +121,22 @@ public:
                  if ((_NA < 0 ) && ( _NB > 0) && (_NB - _NA > sqrt(2. * std::numbers::pi)))                                                         _Alg = 0;
             else if ((_NA >= 0) && ( _NB >  _NA + 2.*sqrt(exp(1.)) / ( _NA + sqrt(Sqr(_NA) + 4.)) * exp((_NA*2. -  _NA*sqrt(Sqr(_NA) + 4.)) / 4.))) _Alg = 1;
             else if ((_NB <= 0) && (-_NA > -_NB + 2.*sqrt(exp(1.)) / (-_NB + sqrt(Sqr(_NB) + 4.)) * exp((_NB*2. - -_NB*sqrt(Sqr(_NB) + 4.)) / 4.))) _Alg = 2;
+
+            // rejection-free inverse-CDF sampling (algorithm 4): x = Phi^-1(Phi(lo) + u*(Phi(hi)-Phi(lo)))
+            // a range in the upper tail is mirrored to the lower tail, where the probabilities have full relative precision.
+            // ranges beyond NormalQuantile's domain (probabilities < 1e-300: |x| > ~37) keep the rejection algorithm
+            _InvCDF = _InvCDF0;
+            if (_InvCDF)
+            {
+                _Flip = _NA > 0 ? -1. : 1.;
+                _Lo   = _NA > 0 ? -_NB : _NA;
+                _Hi   = _NA > 0 ? -_NA : _NB;
+                _PLo  = erfc(-_Lo / std::numbers::sqrt2) / 2.;
+                _PD   = erfc(-_Hi / std::numbers::sqrt2) / 2. - _PLo;
+
+                if (_PLo >= 1e-300 && _PD >= 1e-300)
+                    _Alg = 4;
+            }
         }
 
         _Ty _Mean ;
@@ -122,17 +149,27 @@ public:
         _Ty _NA   ; // _A normalized
         _Ty _NB   ; // _B normalized
         int _Alg  ; // algorithm to use
+
+        // algorithm 4 (inverse-CDF)
+        bool   _InvCDF = false; // requested
+        double _Flip   = 1.   ; // -1: the range is mirrored
+        double _Lo     = 0.   ; // normalized range, after mirroring
+        double _Hi     = 0.   ;
+        double _PLo    = 0.   ; // Phi(_Lo)
+        double _PD     = 0.   ; // Phi(_Hi) - Phi(_Lo)
     };
 
     // normal distribution is first truncated, and then wrapped
-    explicit wrapped_truncated_normal_distribution(_Ty _Mean0  =    0.                           ,
-                                                   _Ty _Sigma0 =    1.                           ,
-                                                   _Ty _A0     = std::numeric_limits< _Ty>::min(),   // truncation-range lower-bound
-                                                   _Ty _B0     = std::numeric_limits< _Ty>::max(),   // truncation-range upper-bound
-                                                   _Ty _L0     = -180.                           ,   // wrapping  -range lower-bound
-                                                   _Ty _H0     =  180.                            )  // wrapping  -range upper-bound
-
-        : _Par(_Mean0, _Sigma0, _A0, _B0, _L0, _H0)
+    // _InvCDF0: rejection-free inverse-CDF sampling - constant per-sample cost, regardless of the truncation-range
+    explicit wrapped_truncated_normal_distribution(_Ty  _Mean0   =    0.                           ,
+                                                   _Ty  _Sigma0  =    1.                           ,
+                                                   _Ty  _A0      = std::numeric_limits< _Ty>::min(),   // truncation-range lower-bound
+                                                   _Ty  _B0      = std::numeric_limits< _Ty>::max(),   // truncation-range upper-bound
+                                                   _Ty  _L0      = -180.                           ,   // wrapping  -range lower-bound
+                                                   _Ty  _H0      =  180.                           ,   // wrapping  -range upper-bound
+                                                   bool _InvCDF0 = false                            )  // inverse-CDF sampling
+
+        : _Par(_Mean0, _Sigma0, _A0, _B0, _L0, _H0, _InvCDF0)
     {   // construct
     }
 
@@ -214,35 +251,98 @@ public:
         return _Eval(_Eng, _Par0);
     }
 
+    // fill [_First,_Last) with values (batch sampling)
+    // with inverse-CDF sampling, the values are generated in blocks: uniform values are drawn from the engine, transformed
+    // by the branch-free Phi^-1, and then wrapped by the SIMD wrap kernel - all in straight loops over arrays.
+    // otherwise, this is a loop of operator() calls
+    template<class _Engine, class _FwdIt>
+    void generate(_Engine& _Eng, _FwdIt _First, _FwdIt _Last)
+    {   // fill range with next values
+        if (_Par._Alg != 4)
+        {
+            for (; _First != _Last; ++_First)
+                *_First = _Eval(_Eng, _Par);
+            return;
+        }
+
+        constexpr size_t _BlockSize = 512;
+
+        double _U  [_BlockSize]; // uniform values
+        _Ty    _Buf[_BlockSize]; // values
+
+        for (size_t _Count = std::distance(_First, _Last); _Count > 0; )
+        {
+            const size_t _N = _Count < _BlockSize ? _Count : _BlockSize;
+
+            for (size_t i = 0; i < _N; ++i)
+                _U[i] = _NRAND(_Eng, double);
+
+            for (size_t i = 0; i < _N; ++i)
+                _Buf[i] = _InvCDFSample(_U[i], _Par);
+
+            _WrapBlock(_Buf, _N, _Par);
+
+            for (size_t i = 0; i < _N; ++i, ++_First)
+                *_First = _Buf[i];
+
+            _Count -= _N;
+        }
+    }
+
+    template<class _Engine>
+    void generate(_Engine& _Eng, std::span<_Ty> _Out)
+    {   // fill span with next values
+        generate(_Eng, _Out.begin(), _Out.end());
+    }
+
+    // state format version 2: 'v2', then 7 values: mean, sigma, A, B, L, H, and the inverse-CDF flag (0 or 1)
+    // version 1 (no version tag): the first 6 values - read with the flag off
     template<class _Elem, class _Traits>
     basic_istream<_Elem, _Traits>& _Read(basic_istream<_Elem, _Traits>& _Istr)
     {   // read state from _Istr
+        int _Version = 1;
+        if ((_Istr >> std::ws).peek() == _Traits::to_int_type(_Istr.widen('v')))
+        {
+            _Istr.get();
+            _Istr >> _Version;
+            if (_Version != 2)
+            {
+                _Istr.setstate(std::ios_base::failbit);
+                return _Istr;
+            }
+        }
+
         _Ty _Mean0 ;
         _Ty _Sigma0;
         _Ty _A0    ;
         _Ty _B0    ;
         _Ty _L0    ;
         _Ty _H0    ;
+        _Ty _InvCDF0 = 0;
         _In(_Istr, _Mean0 );
         _In(_Istr, _Sigma0);
         _In(_Istr, _A0    );
         _In(_Istr, _B0    );
         _In(_Istr, _L0    );
         _In(_Istr, _H0    );
-        _Par._Init(_Mean0, _Sigma0, _A0, _B0, _L0, _H0);
+        if (_Version >= 2)
+            _In(_Istr, _InvCDF0);
+        _Par._Init(_Mean0, _Sigma0, _A0, _B0, _L0, _H0, _InvCDF0 != 0);
 
         return _Istr;
     }
 
     template<class _Elem, class _Traits>
     basic_ostream<_Elem, _Traits>& _Write(basic_ostream<_Elem, _Traits>& _Ostr) const
-    {   // write state to _Ostr
+    {   // write state to _Ostr (format version 2)
+        _Ostr << _Ostr.widen('v') << 2 << _Ostr.widen(' ');
         _Out(_Ostr, _Par._Mean );
         _Out(_Ostr, _Par._Sigma);
         _Out(_Ostr, _Par._A    );
         _Out(_Ostr, _Par._B    );
         _Out(_Ostr, _Par._L    );
         _Out(_Ostr, _Par._H    );
+        _Out(_Ostr, _Ty(_Par._InvCDF));
 
         return _Ostr;
     }
@@ -254,6 +354,9 @@ private:
 
         switch (_Par0._Alg)
         {
+        case 4 :
+            return _Wrap(_InvCDFSample(_NRAND(_Eng, double), _Par0), _Par0);
+
         case 0 :
             {
                 normal_distribution<_Ty> nd;
@@ -316,8 +419,32 @@ private:
             }
         }
 
-        result_type d = _Res * _Par0._Sigma + _Par0._Mean;        // denormalize result
-        return Mod(d - _Par0._L, _Par0._H - _Par0._L) + _Par0._L; // wrap        result
+        return _Wrap(_Res * _Par0._Sigma + _Par0._Mean, _Par0);  // denormalize result
+    }
+
+    static _Ty _InvCDFSample(double _U, const param_type& _Par0)
+    {   // algorithm 4: denormalized (not wrapped) value for the uniform value _U in [0,1)
+        double z = NormalQuantile(_Par0._PLo + _U * _Par0._PD);
+        z = std::min(std::max(z, _Par0._Lo), _Par0._Hi);   // approximation error near the range bounds
+        return (_Ty)(_Par0._Flip * z * _Par0._Sigma + _Par0._Mean);
+    }
+
+    static _Ty _Wrap(_Ty d, const param_type& _Par0)
+    {   // wrap result
+        return Mod(d - _Par0._L, _Par0._H - _Par0._L) + _Par0._L;
+    }
+
+    static void _WrapBlock(_Ty* _Out, size_t _N, const param_type& _Par0)
+    {   // wrap results
+        const _Ty _R = _Par0._H - _Par0._L;
+
+        size_t i = 0;
+        if constexpr (std::is_same_v<_Ty, double>)
+            if (_R > 0)
+                i = SimdWrap(_Out, _Out, _N, _Par0._L, _Par0._H, _R);
+
+        for (; i < _N; ++i)
+            _Out[i] = _Wrap(_Out[i], _Par0);
     }
 
     int        _Alg; // which algorithm to use